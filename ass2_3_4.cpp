@@ -1,3 +1,10 @@
+// Build:  g++ -std=c++17 -O2 -pthread ass2_3_4.cpp -o university
+// Run:    ./university          the demo
+//         ./university test     checks; exits with 1 if any fails
+//         ./university bench    benchmarks
+// Allocation counts in the benchmarks need a build that adds
+// -DUNIVERSITY_COUNT_ALLOCATIONS to the line above (see COUNTING_BUILD).
+
 #include <iostream>
 #include <vector>
 #include <map>
@@ -7,11 +14,134 @@
 #include <stdexcept>
 #include <fstream>
 #include<ctime>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <condition_variable>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <string_view>
+#include <charconv>
+#include <array>
+#include <random>
+#include <tuple>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define UNIVERSITY_HAVE_AVX2 1
+#endif
 using namespace std;
 
 //Functions Prototype
 bool dateValidator(string&);
+uint32_t parseDate(string_view);
+size_t parseDates(const string_view*, size_t, uint32_t*);
+string formatDate(uint32_t, bool four_digit_year = false);
+class Person;
+double payrollAmount(Person*);
+uint32_t payrollDepartment(Person*);
+double storeGPA(Person*);
+
+// Dates are packed as year << 9 | month << 5 | day so that they compare in
+// calendar order; 0 means no date.
+constexpr uint32_t packDate(int day, int month, int year){
+    return (uint32_t)year << 9 | (uint32_t)month << 5 | (uint32_t)day;
+}
+
+// Whether a date was typed as DD/MM/YYYY. Owners of a packed date keep this
+// beside it so formatDate can print the year back the way it came in.
+inline bool fourDigitYear(string_view date){
+    size_t slash = date.rfind('/');
+    return slash != string_view::npos && date.size() - slash == 5;
+}
+
+// POWERS_OF_TEN[i] is 10^i, built at compile time so a digit count check is a
+// range compare instead of a divide-by-10 loop.
+constexpr array<uint64_t, 20> makePowersOfTen(){
+    array<uint64_t, 20> powers = {};
+    powers[0] = 1;
+    for (size_t i = 1; i < powers.size(); i++) powers[i] = powers[i - 1] * 10;
+    return powers;
+}
+constexpr array<uint64_t, 20> POWERS_OF_TEN = makePowersOfTen();
+
+// True if value has exactly digits (1 to 20) decimal digits, ignoring its sign.
+constexpr bool hasDigitCount(long long value, int digits){
+    uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+    return magnitude >= POWERS_OF_TEN[digits - 1] && (digits == 20 || magnitude < POWERS_OF_TEN[digits]);
+}
+static_assert(hasDigitCount(12345, 5) && hasDigitCount(-99999, 5) && !hasDigitCount(9999, 5) && !hasDigitCount(100000, 5), "5 digit range");
+static_assert(hasDigitCount(9817256938, 10) && !hasDigitCount(999999999, 10) && !hasDigitCount(0, 1), "10 digit range");
+
+// The one rule for person IDs (5 digits) and contact numbers (10 digits), used
+// by Person's setters and PersonFieldValidator alike. Negative values fail.
+constexpr bool validPersonID(long long ID){
+    return ID >= 0 && hasDigitCount(ID, 5);
+}
+constexpr bool validContactNumber(long long number){
+    return number >= 0 && hasDigitCount(number, 10);
+}
+static_assert(validPersonID(10000) && !validPersonID(-12345) && !validContactNumber(-9876543210LL), "no negatives");
 void testAssistantFunctionality();
+void benchmarkConcurrentEnrollment();
+void benchmarkGradeAnalytics();
+void benchmarkSnapshot();
+void benchmarkWriteAheadLog();
+void benchmarkBulkImport();
+void benchmarkTimetable();
+void benchmarkPayroll();
+void benchmarkPersonPool();
+void benchmarkPersonStore();
+void benchmarkIndexes();
+void benchmarkSymbols();
+void benchmarkAllocations();
+void benchmarkErrorPath();
+void benchmarkDigitValidation();
+void testWriteAheadLog();
+void testWaitlist();
+void testObjectPool();
+void testGradeBook();
+void testPersonAssignment();
+void testPersonFieldValidator();
+void testSnapshot();
+void testScheduleConflicts();
+void testTimetable();
+int reportChecks();
+
+// Heap allocations made by the calling thread. Only benchmark builds
+// (-DUNIVERSITY_COUNT_ALLOCATIONS) replace operator new to count them; in
+// other builds the count stays 0 and the benchmarks say so.
+thread_local uint64_t thread_allocations = 0;
+const char* const COUNTING_BUILD = "g++ -std=c++17 -O2 -pthread -DUNIVERSITY_COUNT_ALLOCATIONS ass2_3_4.cpp -o university";
+
+#ifdef UNIVERSITY_COUNT_ALLOCATIONS
+void* operator new(size_t size){
+    thread_allocations++;
+    if (size == 0) size = 1;
+    while (true) {
+        if (void* memory = malloc(size)) return memory;
+        new_handler handler = get_new_handler();
+        if (handler == nullptr) throw bad_alloc();
+        handler();
+    }
+}
+// Kept out of line: GCC pairs an inlined free() with new expressions and warns.
+__attribute__((noinline)) void operator delete(void* memory) noexcept { free(memory); }
+__attribute__((noinline)) void operator delete(void* memory, size_t) noexcept { free(memory); }
+#endif
 
 
 //Classes
@@ -23,7 +153,7 @@ class UniversitySystemException : public exception {
         int errorCode;
     public:
         UniversitySystemException(string message = "University System Error", int errorCode = 0) {
-            this->message = message;
+            this->message = move(message);
             this->errorCode = errorCode;
         }
         
@@ -46,16 +176,16 @@ class EnrollmentException : public UniversitySystemException {
         string courseCode;
     public:
         EnrollmentException(string message, string studentID, string courseCode, int errorCode = 100) 
-            : UniversitySystemException(message, errorCode) {
-            this->studentID = studentID;
-            this->courseCode = courseCode;
+            : UniversitySystemException(move(message), errorCode) {
+            this->studentID = move(studentID);
+            this->courseCode = move(courseCode);
         }
             
-        string getStudentID() const {
+        const string& getStudentID() const {
             return studentID;
         }
             
-        string getCourseCode() const {
+        const string& getCourseCode() const {
             return courseCode;
         }
             
@@ -72,7 +202,7 @@ class CourseFullException : public EnrollmentException {
         int currentEnrollment;
     public:
         CourseFullException(string studentID, string courseCode, int maxCapacity, int currentEnrollment) 
-            : EnrollmentException("Course is at maximum capacity", studentID, courseCode, 101) {
+            : EnrollmentException("Course is at maximum capacity", move(studentID), move(courseCode), 101) {
             this->maxCapacity = maxCapacity;
             this->currentEnrollment = currentEnrollment;
         }
@@ -98,16 +228,16 @@ class EnrollmentDeadlineException : public EnrollmentException {
         string currentDate;
     public:
         EnrollmentDeadlineException(string studentID, string courseCode, string deadline, string currentDate) 
-            : EnrollmentException("Enrollment deadline has passed", studentID, courseCode, 103) {
-            this->deadline = deadline;
-            this->currentDate = currentDate;
+            : EnrollmentException("Enrollment deadline has passed", move(studentID), move(courseCode), 103) {
+            this->deadline = move(deadline);
+            this->currentDate = move(currentDate);
         }
             
-        string getDeadline() const {
+        const string& getDeadline() const {
             return deadline;
         }
             
-        string getCurrentDate() const {
+        const string& getCurrentDate() const {
             return currentDate;
         }
             
@@ -124,16 +254,16 @@ class GradeException : public UniversitySystemException {
         string courseCode;
     public:
         GradeException(string message, string studentID, string courseCode, int errorCode = 200) 
-            : UniversitySystemException(message, errorCode) {
-            this->studentID = studentID;
-            this->courseCode = courseCode;
+            : UniversitySystemException(move(message), errorCode) {
+            this->studentID = move(studentID);
+            this->courseCode = move(courseCode);
         }
         
-        string getStudentID() const {
+        const string& getStudentID() const {
             return studentID;
         }
         
-        string getCourseCode() const {
+        const string& getCourseCode() const {
             return courseCode;
         }
         
@@ -151,7 +281,7 @@ class InvalidGradeException : public GradeException {
         int maxGrade;
     public:
         InvalidGradeException(string studentID, string courseCode, int invalidGrade, int minGrade = 0, int maxGrade = 100) 
-            : GradeException("Invalid grade value", studentID, courseCode, 201) {
+            : GradeException("Invalid grade value", move(studentID), move(courseCode), 201) {
             this->invalidGrade = invalidGrade;
             this->minGrade = minGrade;
             this->maxGrade = maxGrade;
@@ -181,11 +311,11 @@ class RequirementsNotCompleteException : public GradeException {
         vector<string> missingRequirements;
     public:
         RequirementsNotCompleteException(string studentID, string courseCode, vector<string> missingReqs) 
-            : GradeException("Student has not completed all requirements", studentID, courseCode, 203) {
-            this->missingRequirements = missingReqs;
+            : GradeException("Student has not completed all requirements", move(studentID), move(courseCode), 203) {
+            this->missingRequirements = move(missingReqs);
         }
         
-        vector<string> getMissingRequirements() const {
+        const vector<string>& getMissingRequirements() const {
             return missingRequirements;
         }
         
@@ -207,12 +337,12 @@ class PaymentException : public UniversitySystemException {
         double amount;
     public:
         PaymentException(string message, string personID, double amount, int errorCode = 300) 
-            : UniversitySystemException(message, errorCode) {
-            this->personID = personID;
+            : UniversitySystemException(move(message), errorCode) {
+            this->personID = move(personID);
             this->amount = amount;
         }
         
-        string getPersonID() const {
+        const string& getPersonID() const {
             return personID;
         }
         
@@ -232,11 +362,11 @@ class PaymentCalculationException : public PaymentException {
         string reason;
     public:
         PaymentCalculationException(string personID, double amount, string reason) 
-               : PaymentException("Error calculating payment", personID, amount, 301) {
-                this->reason = reason;
+               : PaymentException("Error calculating payment", move(personID), amount, 301) {
+                this->reason = move(reason);
         }
             
-        string getReason() const {
+        const string& getReason() const {
             return reason;
         }
             
@@ -250,7 +380,7 @@ class InsufficientFundsException : public PaymentException {
         double availableFunds;
     public:
         InsufficientFundsException(string personID, double amount, double availableFunds) 
-            : PaymentException("Insufficient funds for payment", personID, amount, 302) {
+            : PaymentException("Insufficient funds for payment", move(personID), amount, 302) {
             this->availableFunds = availableFunds;
         }
             
@@ -270,11 +400,11 @@ class PersonException : public UniversitySystemException {
         string personID;
     public:
         PersonException(string message, string personID, int errorCode = 400) 
-            : UniversitySystemException(message, errorCode) {
-            this->personID = personID;
+            : UniversitySystemException(move(message), errorCode) {
+            this->personID = move(personID);
         }
         
-        string getPersonID() const {
+        const string& getPersonID() const {
             return personID;
         }
         
@@ -289,16 +419,16 @@ class InvalidIDException : public PersonException {
         string reason;
     public:
         InvalidIDException(string personID, string invalidID, string reason) 
-            : PersonException("Invalid person ID", personID, 401) {
-            this->invalidID = invalidID;
-            this->reason = reason;
+            : PersonException("Invalid person ID", move(personID), 401) {
+            this->invalidID = move(invalidID);
+            this->reason = move(reason);
         }
         
-        string getInvalidID() const {
+        const string& getInvalidID() const {
             return invalidID;
         }
         
-        string getReason() const {
+        const string& getReason() const {
             return reason;
         }
         
@@ -315,16 +445,16 @@ class InvalidContactInfoException : public PersonException {
         string reason;
     public:
         InvalidContactInfoException(string personID, string invalidContact, string reason) 
-            : PersonException("Invalid contact information", personID, 402) {
-            this->invalidContact = invalidContact;
-            this->reason = reason;
+            : PersonException("Invalid contact information", move(personID), 402) {
+            this->invalidContact = move(invalidContact);
+            this->reason = move(reason);
         }
         
-        string getInvalidContact() const {
+        const string& getInvalidContact() const {
             return invalidContact;
         }
         
-        string getReason() const {
+        const string& getReason() const {
             return reason;
         }
         
@@ -338,74 +468,666 @@ class InvalidContactInfoException : public PersonException {
 
 
 
+// Maps strings to dense integer ids. Ids are handed out in first-seen order and
+// never reused, so they can index plain vectors. Safe to share between threads.
+class StringInterner{
+private:
+    mutable shared_mutex lock;
+    unordered_map<string, uint32_t> ids;
+    vector<const string*> names;
+public:
+    StringInterner(){}
+
+    uint32_t intern(const string& text){
+        {
+            shared_lock<shared_mutex> reader(lock);
+            auto it = ids.find(text);
+            if (it != ids.end()) return it->second;
+        }
+        unique_lock<shared_mutex> writer(lock);
+        auto result = ids.emplace(text, (uint32_t)names.size());
+        if (result.second) names.push_back(&result.first->first);
+        return result.first->second;
+    }
+
+    bool lookup(const string& text, uint32_t& id) const {
+        shared_lock<shared_mutex> reader(lock);
+        auto it = ids.find(text);
+        if (it == ids.end()) return false;
+        id = it->second;
+        return true;
+    }
+
+    const string& name(uint32_t id) const {
+        shared_lock<shared_mutex> reader(lock);
+        return *names[id];
+    }
+
+    size_t size() const {
+        shared_lock<shared_mutex> reader(lock);
+        return names.size();
+    }
+};
+
+// Program-wide symbols for short strings that repeat across many records:
+// course codes, department names, programs, majors and minors. Objects store
+// the 32-bit symbol and compare symbols instead of strings. Symbol 0 is "".
+inline StringInterner& symbols(){
+    static StringInterner table;
+    static const uint32_t empty = table.intern("");
+    (void)empty;
+    return table;
+}
+
+inline uint32_t intern(const string& text){
+    return symbols().intern(text);
+}
+
+inline const string& symbolText(uint32_t symbol){
+    return symbols().name(symbol);
+}
+
+// File Course::writeToErrorLog appends to. Benchmark runs point it at a
+// scratch file and delete that afterwards.
+inline string& errorLogPath(){
+    static string path = "university_system_error.log";
+    return path;
+}
+
+// A failed operation as its error code plus the raw values needed to describe
+// it. Building one does not allocate; message() is a static string and
+// getDetails() formats the same text the matching exception would, only when
+// asked. raise() throws that exception for callers using the throwing API.
+struct UniversityError {
+    int code = 0;
+    int personID = 0;         // the person, or the student for enrollment errors
+    long long value = 0;      // rejected ID, contact number or age; capacity for 101
+    uint32_t course = 0;      // course code symbol
+    uint32_t deadline = 0;    // packed dates for 103
+    uint32_t date = 0;
+    int enrolled = 0;         // seats taken for 101
+    bool deadline_full_year = false;
+    bool date_full_year = false;
+
+    UniversityError() {}
+    UniversityError(int code, int personID, long long value = 0, uint32_t course = 0)
+        : code(code), personID(personID), value(value), course(course) {}
+
+    const char* message() const {
+        switch (code) {
+            case 101: return "Course is at maximum capacity";
+            case 102: return "Invalid current date format";
+            case 103: return "Enrollment deadline has passed";
+            case 104: return "Student not found in course";
+            case 610: return "Change made but write-ahead log write failed";
+            case 401: return "Invalid person ID";
+            case 402: return "Invalid contact information";
+            case 403: return "Name cannot be empty";
+            case 404: return "Age cannot be negative";
+            case 405: return "Age exceeds maximum allowed";
+            default: return "University System Error";
+        }
+    }
+
+    const char* reason() const {
+        if (code == 401) return "ID must be 5 digits";
+        if (code == 402) return "Contact number must be 10 digits";
+        return "";
+    }
+
+    string getDetails() const {
+        string details = "Error Code: " + to_string(code) + ", Message: " + message();
+        if ((code >= 100 && code < 200) || code == 610) {
+            details += ", Student ID: " + to_string(personID) + ", Course Code: " + symbolText(course);
+            if (code == 101) details += ", Max Capacity: " + to_string(value) + ", Current Enrollment: " + to_string(enrolled);
+            if (code == 103) details += ", Deadline: " + formatDate(deadline, deadline_full_year) + ", Current Date: " + formatDate(date, date_full_year);
+            return details;
+        }
+        details += ", Person ID: " + to_string(personID);
+        if (code == 401) details += ", Invalid ID: " + to_string(value) + ", Reason: " + reason();
+        if (code == 402) details += ", Invalid Contact: " + to_string(value) + ", Reason: " + reason();
+        return details;
+    }
+
+    [[noreturn]] void raise() const {
+        string person = to_string(personID);
+        switch (code) {
+            case 101: throw CourseFullException(person, symbolText(course), value, enrolled);
+            case 102: case 104: case 610: throw EnrollmentException(message(), person, symbolText(course), code);
+            case 103: throw EnrollmentDeadlineException(person, symbolText(course), formatDate(deadline, deadline_full_year), formatDate(date, date_full_year));
+            case 401: throw InvalidIDException(person, to_string(value), reason());
+            case 402: throw InvalidContactInfoException(person, to_string(value), reason());
+            default: throw PersonException(message(), person, code);
+        }
+    }
+};
+
+// What a non-throwing call returns: its value, or the UniversityError that
+// stopped it. Result<void> carries only the error.
+template <typename T>
+class Result {
+private:
+    T result{};
+    UniversityError failure;
+public:
+    Result(T value) : result(move(value)) {}
+    Result(const UniversityError& error) : failure(error) {}
+
+    bool ok() const { return failure.code == 0; }
+    explicit operator bool() const { return ok(); }
+    const T& value() const { return result; }
+    const UniversityError& error() const { return failure; }
+    const T& valueOrThrow() const {
+        if (!ok()) failure.raise();
+        return result;
+    }
+};
+
+template <>
+class Result<void> {
+private:
+    UniversityError failure;
+public:
+    Result() {}
+    Result(const UniversityError& error) : failure(error) {}
+
+    bool ok() const { return failure.code == 0; }
+    explicit operator bool() const { return ok(); }
+    const UniversityError& error() const { return failure; }
+    void orThrow() const {
+        if (!ok()) failure.raise();
+    }
+};
+
+// Running payroll totals for the university and each department, kept up
+// to date as people join, leave or have a pay-related field changed. Readers
+// get the totals without walking anyone. Must outlive the people attached to
+// it (see Person::setPayrollLedger).
+class PayrollLedger {
+public:
+    struct Account {
+        size_t people = 0;
+        double total = 0;
+    };
+private:
+    mutable mutex lock;
+    unordered_map<uint32_t, Account> departments;
+    Account university;
+public:
+    PayrollLedger() {}
+    PayrollLedger(const PayrollLedger&) = delete;
+    PayrollLedger& operator=(const PayrollLedger&) = delete;
+
+    void join(uint32_t department, double amount) {
+        lock_guard<mutex> guard(lock);
+        Account& account = departments[department];
+        account.people++;
+        account.total += amount;
+        university.people++;
+        university.total += amount;
+    }
+
+    void leave(uint32_t department, double amount) {
+        lock_guard<mutex> guard(lock);
+        auto account = departments.find(department);
+        if (account == departments.end()) return;
+        account->second.total -= amount;
+        if (--account->second.people == 0) departments.erase(account);
+        university.people--;
+        university.total -= amount;
+    }
+
+    void adjust(uint32_t department, double delta) {
+        lock_guard<mutex> guard(lock);
+        departments[department].total += delta;
+        university.total += delta;
+    }
+
+    double getTotal() const {
+        lock_guard<mutex> guard(lock);
+        return university.total;
+    }
+
+    size_t getPeopleCount() const {
+        lock_guard<mutex> guard(lock);
+        return university.people;
+    }
+
+    Account getDepartment(const string& name) const {
+        uint32_t department;
+        if (!symbols().lookup(name, department)) return Account();
+        lock_guard<mutex> guard(lock);
+        auto account = departments.find(department);
+        return account == departments.end() ? Account() : account->second;
+    }
+
+    // Sorted by department name; people without one are listed as "Unassigned".
+    vector<pair<string, Account>> getDepartments() const {
+        vector<pair<string, Account>> result;
+        {
+            lock_guard<mutex> guard(lock);
+            for (auto& account : departments) result.push_back({account.first == 0 ? "Unassigned" : symbolText(account.first), account.second});
+        }
+        sort(result.begin(), result.end(), [](const pair<string, Account>& a, const pair<string, Account>& b) { return a.first < b.first; });
+        return result;
+    }
+
+    void display() {
+        ios::fmtflags flags = cout.flags();
+        streamsize precision = cout.precision(2);
+        cout << fixed;
+        cout << "Payroll for " << getPeopleCount() << " People: " << getTotal() << "\n";
+        for (auto& department : getDepartments()) {
+            cout << department.first << " (" << department.second.people << "):\t" << department.second.total << "\n";
+        }
+        cout.flags(flags);
+        cout.precision(precision);
+    }
+};
+
+
+// Hot scalar fields of every attached person kept column by column, with the
+// names packed into one character heap. Filters and lookups scan these arrays
+// instead of visiting each object. Rows are written through by the Person
+// setters (see Person::setPersonStore); a row's number can change when another
+// row is removed, so hold on to the Person* rather than the row. Non-students
+// have a NaN GPA, which never passes a GPA filter. IDs and contact numbers are
+// also hashed to their rows for exact lookups. Must outlive the people
+// attached to it.
+class PersonStore {
+public:
+    struct Row {
+        string_view name;
+        int ID;
+        int age;
+        long long int contact;
+        double GPA;
+        Person* person;
+    };
+private:
+    mutable shared_mutex lock;
+    vector<Person*> people;
+    vector<uint32_t*> row_numbers;
+    vector<int> IDs;
+    vector<int> ages;
+    vector<long long int> contacts;
+    vector<double> GPAs;
+    vector<uint32_t> name_offsets;
+    vector<uint32_t> name_lengths;
+    string names;
+    size_t dead_name_bytes = 0;
+    // Several people may share an ID or number; lookups return the lowest row.
+    unordered_multimap<int, uint32_t> ID_rows;
+    unordered_multimap<long long int, uint32_t> contact_rows;
+
+    template <typename Index, typename Key>
+    static void unindex(Index& index, const Key& key, uint32_t row) {
+        auto range = index.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == row) {
+                index.erase(it);
+                return;
+            }
+        }
+    }
+
+    template <typename Index, typename Key>
+    Person* lookup(const Index& index, const Key& key) const {
+        auto range = index.equal_range(key);
+        if (range.first == range.second) return nullptr;
+        uint32_t row = range.first->second;
+        for (auto it = range.first; it != range.second; ++it) row = min(row, it->second);
+        return people[row];
+    }
+
+    void storeName(uint32_t row, const string& name) {
+        dead_name_bytes += name_lengths[row];
+        if (dead_name_bytes > 4096 && dead_name_bytes > names.size() / 2) compactNames();
+        name_offsets[row] = names.size();
+        name_lengths[row] = name.size();
+        names += name;
+    }
+
+    void compactNames() {
+        string packed;
+        packed.reserve(names.size() - dead_name_bytes);
+        for (size_t row = 0; row < people.size(); row++) {
+            uint32_t offset = packed.size();
+            packed.append(names, name_offsets[row], name_lengths[row]);
+            name_offsets[row] = offset;
+        }
+        names.swap(packed);
+        dead_name_bytes = 0;
+    }
+
+    template <typename Keep>
+    vector<Person*> select(Keep keep) const {
+        vector<Person*> result;
+        shared_lock<shared_mutex> guard(lock);
+        for (size_t row = 0; row < people.size(); row++) {
+            if (keep(row)) result.push_back(people[row]);
+        }
+        return result;
+    }
+public:
+    PersonStore() {}
+    PersonStore(const PersonStore&) = delete;
+    PersonStore& operator=(const PersonStore&) = delete;
+
+    // row_number is where the store keeps the owner's current row up to date.
+    uint32_t add(Person* person, uint32_t* row_number, const string& name, int ID, int age, long long int contact, double GPA) {
+        unique_lock<shared_mutex> guard(lock);
+        uint32_t row = people.size();
+        people.push_back(person);
+        row_numbers.push_back(row_number);
+        IDs.push_back(ID);
+        ages.push_back(age);
+        contacts.push_back(contact);
+        GPAs.push_back(GPA);
+        name_offsets.push_back(names.size());
+        name_lengths.push_back(name.size());
+        names += name;
+        ID_rows.emplace(ID, row);
+        contact_rows.emplace(contact, row);
+        *row_number = row;
+        return row;
+    }
+
+    // Moves the last row into the freed one.
+    void remove(uint32_t row) {
+        unique_lock<shared_mutex> guard(lock);
+        if (row >= people.size()) return;
+        dead_name_bytes += name_lengths[row];
+        uint32_t last = people.size() - 1;
+        unindex(ID_rows, IDs[row], row);
+        unindex(contact_rows, contacts[row], row);
+        if (row != last) {
+            unindex(ID_rows, IDs[last], last);
+            unindex(contact_rows, contacts[last], last);
+            ID_rows.emplace(IDs[last], row);
+            contact_rows.emplace(contacts[last], row);
+            people[row] = people[last];
+            row_numbers[row] = row_numbers[last];
+            IDs[row] = IDs[last];
+            ages[row] = ages[last];
+            contacts[row] = contacts[last];
+            GPAs[row] = GPAs[last];
+            name_offsets[row] = name_offsets[last];
+            name_lengths[row] = name_lengths[last];
+            *row_numbers[row] = row;
+        }
+        people.pop_back();
+        row_numbers.pop_back();
+        IDs.pop_back();
+        ages.pop_back();
+        contacts.pop_back();
+        GPAs.pop_back();
+        name_offsets.pop_back();
+        name_lengths.pop_back();
+        if (people.empty()) {
+            names.clear();
+            dead_name_bytes = 0;
+        }
+    }
+
+    void update(uint32_t row, int ID, int age, long long int contact, double GPA) {
+        unique_lock<shared_mutex> guard(lock);
+        if (IDs[row] != ID) {
+            unindex(ID_rows, IDs[row], row);
+            ID_rows.emplace(ID, row);
+        }
+        if (contacts[row] != contact) {
+            unindex(contact_rows, contacts[row], row);
+            contact_rows.emplace(contact, row);
+        }
+        IDs[row] = ID;
+        ages[row] = age;
+        contacts[row] = contact;
+        GPAs[row] = GPA;
+    }
+
+    void updateName(uint32_t row, const string& name) {
+        unique_lock<shared_mutex> guard(lock);
+        storeName(row, name);
+    }
+
+    size_t size() const {
+        shared_lock<shared_mutex> guard(lock);
+        return people.size();
+    }
+
+    // The name points into the store and is only valid until the next change to it.
+    Row getRow(uint32_t row) const {
+        shared_lock<shared_mutex> guard(lock);
+        return {string_view(names).substr(name_offsets[row], name_lengths[row]), IDs[row], ages[row], contacts[row], GPAs[row], people[row]};
+    }
+
+    Person* findByID(int ID) const {
+        shared_lock<shared_mutex> guard(lock);
+        return lookup(ID_rows, ID);
+    }
+
+    Person* findByContact(long long int contact) const {
+        shared_lock<shared_mutex> guard(lock);
+        return lookup(contact_rows, contact);
+    }
+
+    vector<Person*> findByName(string_view name) const {
+        return select([&](size_t row) { return name_lengths[row] == name.size() && names.compare(name_offsets[row], name.size(), name) == 0; });
+    }
+
+    vector<Person*> findGPAAbove(double GPA) const {
+        return select([&](size_t row) { return GPAs[row] > GPA; });
+    }
+
+    vector<Person*> findAgeBetween(int low, int high) const {
+        return select([&](size_t row) { return ages[row] >= low && ages[row] <= high; });
+    }
+
+    size_t countGPAAbove(double GPA) const {
+        shared_lock<shared_mutex> guard(lock);
+        size_t count = 0;
+        const double* values = GPAs.data();
+        for (size_t row = 0; row < GPAs.size(); row++) count += values[row] > GPA;
+        return count;
+    }
+
+    size_t countAgeBetween(int low, int high) const {
+        shared_lock<shared_mutex> guard(lock);
+        size_t count = 0;
+        const int* values = ages.data();
+        for (size_t row = 0; row < ages.size(); row++) count += (unsigned)(values[row] - low) <= (unsigned)(high - low);
+        return count;
+    }
+
+    // Average over students only; 0 when there are none.
+    double averageGPA() const {
+        shared_lock<shared_mutex> guard(lock);
+        double total = 0;
+        size_t count = 0;
+        for (double GPA : GPAs) {
+            bool student = GPA == GPA;
+            total += student ? GPA : 0;
+            count += student;
+        }
+        return count == 0 ? 0 : total / count;
+    }
+};
+
+// Adjustments passed to calculatePayment. Students are charged the penalty
+// on top of their fee; staff are paid the bonus on top of their salary.
+struct PaymentContext {
+    double penalty = 0;
+    double bonus = 0;
+};
+
+// Concrete classes of the Person hierarchy, used wherever people are stored
+// or processed outside their objects (snapshots, bulk import).
+enum PersonKind {
+    KIND_PERSON, KIND_STUDENT, KIND_UNDERGRADUATE, KIND_GRADUATE, KIND_PROFESSOR,
+    KIND_ASSISTANT_PROFESSOR, KIND_ASSOCIATE_PROFESSOR, KIND_FULL_PROFESSOR, PERSON_KIND_COUNT
+};
+
 class Person{
         private:
             string name = "";
-            int ID;
+            int ID = 0;
             long long int contact_info = 0;
-            int ageID;
+            int ageID = 0;
+            PayrollLedger* payroll = nullptr;
+            uint32_t payroll_department = 0;
+            double payroll_amount = 0;
+            PersonStore* store = nullptr;
+            uint32_t store_row = 0;
+            friend class UniversitySnapshot;
+            friend class BulkImporter;
+        protected:
+            // Setters that can change pay or department call this afterwards.
+            void publishPayroll() {
+                if (payroll == nullptr) return;
+                uint32_t department = payrollDepartment(this);
+                double amount = payrollAmount(this);
+                if (department != payroll_department) {
+                    payroll->leave(payroll_department, payroll_amount);
+                    payroll->join(department, amount);
+                } else if (amount != payroll_amount) {
+                    payroll->adjust(department, amount - payroll_amount);
+                }
+                payroll_department = department;
+                payroll_amount = amount;
+            }
+            // Setters of stored scalar fields call this afterwards.
+            void publishStore() {
+                if (store != nullptr) store->update(store_row, ID, ageID, contact_info, storeGPA(this));
+            }
+            // Copies every level's fields from other for operator=, which then
+            // republishes once. A subclass override calls its base's first and copies
+            // its own fields only if other is of its type. steal moves strings out of
+            // other; without it other is left unchanged.
+            virtual void assignFields(Person& other, bool steal) {
+                this->name = steal ? move(other.name) : other.name;
+                this->ID = other.ID;
+                this->contact_info = other.contact_info;
+                this->ageID = other.ageID;
+            }
+            // Sends the current values to the attached ledger and store.
+            void republish() {
+                if (store != nullptr) store->updateName(store_row, name);
+                publishStore();
+                publishPayroll();
+            }
         public:
             Person() {};
+            // Copies are not attached to the original's payroll ledger or store.
+            // Assigning keeps the target's own attachments and republishes to them.
+            Person(const Person& other) : name(other.name), ID(other.ID), contact_info(other.contact_info), ageID(other.ageID) {}
+            Person& operator=(const Person& other) {
+                if (this != &other) assignFields(const_cast<Person&>(other), false);
+                republish();
+                return *this;
+            }
+            // Moves take the name's buffer; like copies they stay detached.
+            Person(Person&& other) noexcept : name(move(other.name)), ID(other.ID), contact_info(other.contact_info), ageID(other.ageID) {}
+            // Not noexcept: republish() can allocate in the store.
+            Person& operator=(Person&& other) {
+                if (this != &other) assignFields(other, true);
+                republish();
+                return *this;
+            }
+            virtual ~Person() {
+                if (payroll != nullptr) payroll->leave(payroll_department, payroll_amount);
+                if (store != nullptr) store->remove(store_row);
+            }
             Person(string name, int ageId, int ID, long long int cInfo){
-                this->name = name;
+                this->name = move(name);
                 this->ageID = ageId;
                 this->ID = ID;
                 this->contact_info = cInfo;
             }
         
-            string getPersonName() {return name;}
+            const string& getPersonName() {return name;}
+            PayrollLedger* getPayrollLedger() {return payroll;}
+            PersonStore* getPersonStore() {return store;}
             long long int getPersonContact_info() {return contact_info;}
             int getPersonID() {return ID;}
             int getPersonAgeID() {return ageID;}
         
+            // Adds this person's pay to ledger, taking it off any earlier one; nullptr detaches.
+            void setPayrollLedger(PayrollLedger* ledger) {
+                if (payroll != nullptr) payroll->leave(payroll_department, payroll_amount);
+                payroll = ledger;
+                if (payroll == nullptr) return;
+                payroll_department = payrollDepartment(this);
+                payroll_amount = payrollAmount(this);
+                payroll->join(payroll_department, payroll_amount);
+            }
+
+            // Adds a row for this person to store, removing it from any earlier one; nullptr detaches.
+            void setPersonStore(PersonStore* store) {
+                if (this->store != nullptr) this->store->remove(store_row);
+                this->store = store;
+                if (store != nullptr) store->add(this, &store_row, name, ID, ageID, contact_info, storeGPA(this));
+            }
+        
+            // Silent, non-throwing versions of the validating setters for bulk or
+            // untrusted input; the set* versions below add the messages and throw.
+            Result<void> trySetPersonName(string name){
+                if (name.empty()) return UniversityError(403, ID);
+                this->name = move(name);
+                if (store != nullptr) store->updateName(store_row, this->name);
+                return {};
+            }
+            Result<void> trySetPersonAge(int age){
+                if (age<0) return UniversityError(404, ID, age);
+                if (age>100) return UniversityError(405, ID, age);
+                this->ageID = age;
+                publishStore();
+                return {};
+            }
+            Result<void> trySetPersonID(int ID){
+                if (!validPersonID(ID)) return UniversityError(401, this->ID, ID);
+                this->ID = ID;
+                publishStore();
+                return {};
+            }
+            Result<void> trySetPersonContactInfo(long long int number){
+                if (!validContactNumber(number)) return UniversityError(402, ID, number);
+                this->contact_info = number;
+                publishStore();
+                return {};
+            }
+
             void setPersonName(string name){
-                if (!name.empty()) {
-                    this->name = name;
-                    cout << "New Name set Successfully!\n";
-                }
-                else {
+                Result<void> result = trySetPersonName(move(name));
+                if (!result) {
                     cout << "\nName Cant be empty!";
-                    throw PersonException("Name cannot be empty", to_string(ID), 403);
+                    result.orThrow();
                 }
+                cout << "New Name set Successfully!\n";
             }
             void setPersonAge(int age){
-                if (age<0) { 
-                    cout << "Become existant first! :)\nAge Invalid!\n"; 
-                    throw PersonException("Age cannot be negative", to_string(ID), 404);
+                Result<void> result = trySetPersonAge(age);
+                if (!result) {
+                    if (age<0) cout << "Become existant first! :)\nAge Invalid!\n"; 
+                    else cout << "Its about time to rest old Guy T_T\nAge Invalid\n"; 
+                    result.orThrow();
                 }
-                if (age>100) { 
-                    cout << "Its about time to rest old Guy T_T\nAge Invalid\n"; 
-                    throw PersonException("Age exceeds maximum allowed", to_string(ID), 405);
-                }
-                this->ageID = age;
                 cout << "AgeID successfully Updated!\n";
             }
             void setPersonID(int ID){
-                int cpy = ID, count = 0;
-                while(cpy!=0) {
-                    cpy /= 10; count++;
-                }
-        
-                if (count != 5) {
+                Result<void> result = trySetPersonID(ID);
+                if (!result) {
                     cout << "Id can only be of 5 digits\nID not Set!\n";
-                    throw InvalidIDException(to_string(this->ID), to_string(ID), "ID must be 5 digits");
+                    result.orThrow();
                 }
-        
-                this->ID = ID;
                 cout << "Person ID updated Successfully!\n";
             }
             void setPersonContactInfo(long long int number){
-                long long cpy = number, count = 0;
-                while(cpy!=0) {
-                    cpy /= 10; count++;
-                }
-        
-                if (count != 10) {
+                Result<void> result = trySetPersonContactInfo(number);
+                if (!result) {
                     cout << "Invalid Phone Number!\nDetails Not Updated!\n";
-                    throw InvalidContactInfoException(to_string(ID), to_string(number), "Contact number must be 10 digits");
+                    result.orThrow();
                 }
-        
-                this->contact_info = number;
                 cout << "Person Phone Number updated Successfully!\n";
             }
         
@@ -418,32 +1140,61 @@ class Person{
                 cout << "Contact No:\t" << contact_info << '\n';
             }
         
-            virtual double calculatePayment(){
+            virtual double calculatePayment(const PaymentContext& /*context*/ = PaymentContext()){
                 return 0.0;
             }
+
+            virtual PersonKind getPersonKind() {
+                return KIND_PERSON;
+            }
         };
 void testPerson(Person* person); //Another Function Prototype HEHEHEHEHE
 
 
 class Student : public Person{
     private:
-        string enrollment_date = "", program = "";
+        uint32_t enrollment_date = 0;
+        uint32_t program = 0;
         double GPA = 0;
+        bool enrollment_full_year = false;
     public:
         Student(){}
-        Student(string enrollment, string program, double GPA){
-            this->enrollment_date = enrollment;
-            this->program = program;
+        Student(const string& enrollment, const string& program, double GPA){
+            this->enrollment_date = parseDate(enrollment);
+            this->enrollment_full_year = fourDigitYear(enrollment);
+            this->program = intern(program);
             this->GPA = GPA;
         }
+        // The assignments forward to Person's, which copies this class's fields
+        // through assignFields. The implicit ones would copy them a second time
+        // after Person's had republished, and move strings out twice.
+        Student(const Student&) = default;
+        Student(Student&&) = default;
+        Student& operator=(const Student& other) { Person::operator=(other); return *this; }
+        Student& operator=(Student&& other) { Person::operator=(move(other)); return *this; }
+    protected:
+        void assignFields(Person& other, bool steal) override {
+            Person::assignFields(other, steal);
+            if (Student* from = dynamic_cast<Student*>(&other)) {
+                this->enrollment_date = from->enrollment_date;
+                this->enrollment_full_year = from->enrollment_full_year;
+                this->program = from->program;
+                this->GPA = from->GPA;
+            }
+        }
+    public:
     
-        string getStudentEnrollmentDate() {return enrollment_date;}
-        string getStudentProgram() {return program;}
+        string getStudentEnrollmentDate() {return formatDate(enrollment_date, enrollment_full_year);}
+        uint32_t getStudentEnrollmentDay() {return enrollment_date;}
+        const string& getStudentProgram() {return symbolText(program);}
+        uint32_t getStudentProgramSymbol() {return program;}
         double getStudentGPA() {return GPA;}
     
-        void setStudentEnrollmentDate(string date){
-            if (dateValidator(date)){
-                this->enrollment_date = date;
+        void setStudentEnrollmentDate(const string& date){
+            uint32_t packed = parseDate(date);
+            if (packed != 0){
+                this->enrollment_date = packed;
+                this->enrollment_full_year = fourDigitYear(date);
                 cout << "Date Format is Correct!\nStudent Enrollment Date Updated Successfully!\n";
             }
             else {
@@ -451,9 +1202,10 @@ class Student : public Person{
                 throw UniversitySystemException("Invalid enrollment date format", 500);
             }
         }
-        void setStudentProgram(string p){
+        void setStudentProgram(const string& p){
             if (!p.empty()) {
-                this->program = p;
+                this->program = intern(p);
+                publishPayroll();
                 cout << "Student Program Updated Successfully!\n";
             } else {
                 cout << "Program Cant be empty!\nProgram not updated!\n";
@@ -463,6 +1215,7 @@ class Student : public Person{
         void setStudentGPA(double GPA){
             if (GPA>=0 && GPA<=4){
                 this->GPA = GPA;
+                publishStore();
                 cout << "Student GPA Updated Successfully!\n";
             } else {
                 cout << "GPA should only be between 0-4!\nGPA not updated!\n";
@@ -474,37 +1227,63 @@ class Student : public Person{
         void displayDetails() override{
             Person::displayDetails();
             cout << "Student Details: \n";
-            cout << "Enrollment Date:\t" << enrollment_date << '\n';
-            cout << "Program:\t" << program << '\n';
+            cout << "Enrollment Date:\t" << formatDate(enrollment_date, enrollment_full_year) << '\n';
+            cout << "Program:\t" << symbolText(program) << '\n';
             cout << "GPA:\t" << GPA << '\n';
         }
     
-        double calculatePayment(double panelty=0){
-            return 154500 + panelty;
+        double calculatePayment(const PaymentContext& context = PaymentContext()) override {
+            return BASE_PAYMENT + context.penalty;
+        }
+
+        PersonKind getPersonKind() override {
+            return KIND_STUDENT;
         }
+
+        static constexpr double BASE_PAYMENT = 154500;
     };
 
 class UndergraduateStudent : public Student {
         private:
-            string major = "";
-            string minor = "";
-            string expected_graduation_date = "";
+            uint32_t major = 0;
+            uint32_t minor = 0;
+            uint32_t expected_graduation_date = 0;
+            bool graduation_full_year = false;
         public:
             UndergraduateStudent() {}
-            UndergraduateStudent(string enrollment, string program, double GPA, 
-                                string major, string minor, string expected_graduation_date) : Student(enrollment, program, GPA) {
-                this->major = major;
-                this->minor = minor;
-                this->expected_graduation_date = expected_graduation_date;
+            UndergraduateStudent(const string& enrollment, const string& program, double GPA, 
+                                const string& major, const string& minor, const string& expected_graduation_date) : Student(enrollment, program, GPA) {
+                this->major = intern(major);
+                this->minor = intern(minor);
+                this->expected_graduation_date = parseDate(expected_graduation_date);
+                this->graduation_full_year = fourDigitYear(expected_graduation_date);
+            }
+            UndergraduateStudent(const UndergraduateStudent&) = default;
+            UndergraduateStudent(UndergraduateStudent&&) = default;
+            UndergraduateStudent& operator=(const UndergraduateStudent& other) { Person::operator=(other); return *this; }
+            UndergraduateStudent& operator=(UndergraduateStudent&& other) { Person::operator=(move(other)); return *this; }
+        protected:
+            void assignFields(Person& other, bool steal) override {
+                Student::assignFields(other, steal);
+                if (UndergraduateStudent* from = dynamic_cast<UndergraduateStudent*>(&other)) {
+                    this->major = from->major;
+                    this->minor = from->minor;
+                    this->expected_graduation_date = from->expected_graduation_date;
+                    this->graduation_full_year = from->graduation_full_year;
+                }
             }
+        public:
             
-            string getUndergraduateStudentMajor() { return major; }
-            string getUndergraduateStudentMinor() { return minor; }
-            string getUndergraduateStudentExpectedGraduationDate() { return expected_graduation_date; }
+            const string& getUndergraduateStudentMajor() { return symbolText(major); }
+            const string& getUndergraduateStudentMinor() { return symbolText(minor); }
+            uint32_t getUndergraduateStudentMajorSymbol() { return major; }
+            uint32_t getUndergraduateStudentMinorSymbol() { return minor; }
+            string getUndergraduateStudentExpectedGraduationDate() { return formatDate(expected_graduation_date, graduation_full_year); }
+            uint32_t getUndergraduateStudentExpectedGraduationDay() { return expected_graduation_date; }
             
-            void setUndergraduateStudentMajor(string major) {
+            void setUndergraduateStudentMajor(const string& major) {
                 if (!major.empty()) {
-                    this->major = major;
+                    this->major = intern(major);
                     cout << "Undergraduate Student Major Updated Successfully!\n";
                 } else {
                     cout << "Major Cannot be Empty!\nMajor not Updated!\n";
@@ -512,9 +1291,9 @@ class UndergraduateStudent : public Student {
                 }
             }
             
-            void setUndergraduateStudentMinor(string minor) {
+            void setUndergraduateStudentMinor(const string& minor) {
                 if (!minor.empty()) {
-                    this->minor = minor;
+                    this->minor = intern(minor);
                     cout << "Undergraduate Student Minor Updated Successfully!\n";
                 } else {
                     cout << "Minor Cannot be Empty!\nMinor not Updated!\n";
@@ -522,9 +1301,11 @@ class UndergraduateStudent : public Student {
                 }
             }
             
-            void setUndergraduateStudentExpectedGraduationDate(string date) {
-                if (dateValidator(date)) {
-                    this->expected_graduation_date = date;
+            void setUndergraduateStudentExpectedGraduationDate(const string& date) {
+                uint32_t packed = parseDate(date);
+                if (packed != 0) {
+                    this->expected_graduation_date = packed;
+                    this->graduation_full_year = fourDigitYear(date);
                     cout << "Date Format is Correct!\nExpected Graduation Date Updated Successfully!\n";
                 } else {
                     cout << "Date Format Invalid!\n 1. It should be : DD/MM/YY\n2. All Date, Month, Year should be Valid\nExpected Graduation Date Not Updated!\n";
@@ -535,43 +1316,75 @@ class UndergraduateStudent : public Student {
             void displayDetails() override {
                 Student::displayDetails();
                 cout << "Undergraduate Student Details: \n";
-                cout << "Major:\t" << major << '\n';
-                cout << "Minor:\t" << minor << '\n';
-                cout << "Expected Graduation Date:\t" << expected_graduation_date << '\n';
+                cout << "Major:\t" << symbolText(major) << '\n';
+                cout << "Minor:\t" << symbolText(minor) << '\n';
+                cout << "Expected Graduation Date:\t" << formatDate(expected_graduation_date, graduation_full_year) << '\n';
             }
             
-            double calculatePayment() override {
-                return Student::calculatePayment() + 1;
+            double calculatePayment(const PaymentContext& context = PaymentContext()) override {
+                return payment() + context.penalty;
+            }
+
+            PersonKind getPersonKind() override {
+                return KIND_UNDERGRADUATE;
+            }
+
+            static double payment() {
+                return Student::BASE_PAYMENT + 1;
             }
         };
 
 class Professor : public Person{
         private:
-                string department = "", hireDate = "", specialization = "";
+                uint32_t department = 0;
+                string specialization = "";
+                uint32_t hireDate = 0;
+                bool hire_full_year = false;
         public:
                 Professor(){}
-                Professor(string department, string hireDate, string specialization){
-                    this->department = department;
-                    this->hireDate = hireDate;
-                    this->specialization = specialization;
+                Professor(const string& department, const string& hireDate, string specialization){
+                    this->department = intern(department);
+                    this->hireDate = parseDate(hireDate);
+                    this->hire_full_year = fourDigitYear(hireDate);
+                    this->specialization = move(specialization);
+                }
+                Professor(const Professor&) = default;
+                Professor(Professor&&) = default;
+                Professor& operator=(const Professor& other) { Person::operator=(other); return *this; }
+                Professor& operator=(Professor&& other) { Person::operator=(move(other)); return *this; }
+            protected:
+                void assignFields(Person& other, bool steal) override {
+                    Person::assignFields(other, steal);
+                    if (Professor* from = dynamic_cast<Professor*>(&other)) {
+                        this->department = from->department;
+                        this->specialization = steal ? move(from->specialization) : from->specialization;
+                        this->hireDate = from->hireDate;
+                        this->hire_full_year = from->hire_full_year;
+                    }
                 }
+            public:
                 
-                string getProfessorDepartment() {return department;}
-                string getProfessorHireDate() {return hireDate;}
-                string getProfessorSpecialization() {return specialization;}
+                const string& getProfessorDepartment() {return symbolText(department);}
+                uint32_t getProfessorDepartmentSymbol() {return department;}
+                string getProfessorHireDate() {return formatDate(hireDate, hire_full_year);}
+                uint32_t getProfessorHireDay() {return hireDate;}
+                const string& getProfessorSpecialization() {return specialization;}
                 
-                void setProfessorDepartment(string department){
+                void setProfessorDepartment(const string& department){
                     if (!department.empty()){
-                        this->department = department;
+                        this->department = intern(department);
+                        publishPayroll();
                         cout << "Professor Department Set Successfully!\n";
                     }else {
                         cout << "Department Can't Be Empty!\nDepartment not Updated!\n";
                         throw UniversitySystemException("Department cannot be empty", 505);
                     }
                 }
-                void setHireDate(string date){
-                    if (dateValidator(date)){
-                        this->hireDate = date;
+                void setHireDate(const string& date){
+                    uint32_t packed = parseDate(date);
+                    if (packed != 0){
+                        this->hireDate = packed;
+                        this->hire_full_year = fourDigitYear(date);
                         cout << "Date Format is Correct!\nProfessor Hire Date Updated Successfully!\n";
                     }
                     else {
@@ -581,7 +1394,7 @@ class Professor : public Person{
                 }
                 void setProfessorSpecialization(string specialization){
                     if (!specialization.empty()){
-                        this->specialization = specialization;
+                        this->specialization = move(specialization);
                         cout << "Professor Specialization Updated Successfully!\n";
                     } else {
                         cout << "Specialization Can not Be Empty!\n";
@@ -593,14 +1406,20 @@ class Professor : public Person{
                 void displayDetails() override{
                     Person::displayDetails();
                     cout << "Professor Details: \n";
-                    cout << "Department:\t" << department << '\n';
-                    cout << "Hire Date:\t" << hireDate << '\n';
+                    cout << "Department:\t" << symbolText(department) << '\n';
+                    cout << "Hire Date:\t" << formatDate(hireDate, hire_full_year) << '\n';
                     cout << "Specialization:\t" << specialization << '\n';
                 }
                 
-                double calculatePayment(double bonus=0){
-                    return 100500 + bonus;
+                double calculatePayment(const PaymentContext& context = PaymentContext()) override {
+                    return BASE_PAYMENT + context.bonus;
                 }
+
+                PersonKind getPersonKind() override {
+                    return KIND_PROFESSOR;
+                }
+
+                static constexpr double BASE_PAYMENT = 100500;
             };
 
 class GraduateStudent : public Student {
@@ -613,22 +1432,42 @@ private:
     double assistantship_stipend = 0.0;
     int teaching_hours = 0;
     int research_hours = 0;
+    friend class UniversitySnapshot;
 public:
     GraduateStudent() {}
-    GraduateStudent(string enrollment, string program, double GPA,
+    GraduateStudent(const string& enrollment, const string& program, double GPA,
                   string research_topic, string thesis_title) : Student(enrollment, program, GPA) {
-        this->research_topic = research_topic;
-        this->thesis_title = thesis_title;
+        this->research_topic = move(research_topic);
+        this->thesis_title = move(thesis_title);
         this->teaching_assistantship = false;
         this->research_assistantship = false;
         this->assistantship_stipend = 0.0;
         this->teaching_hours = 0;
         this->research_hours = 0;
     }
+    GraduateStudent(const GraduateStudent&) = default;
+    GraduateStudent(GraduateStudent&&) = default;
+    GraduateStudent& operator=(const GraduateStudent& other) { Person::operator=(other); return *this; }
+    GraduateStudent& operator=(GraduateStudent&& other) { Person::operator=(move(other)); return *this; }
+protected:
+    void assignFields(Person& other, bool steal) override {
+        Student::assignFields(other, steal);
+        if (GraduateStudent* from = dynamic_cast<GraduateStudent*>(&other)) {
+            this->research_topic = steal ? move(from->research_topic) : from->research_topic;
+            this->advisor = from->advisor;
+            this->thesis_title = steal ? move(from->thesis_title) : from->thesis_title;
+            this->teaching_assistantship = from->teaching_assistantship;
+            this->research_assistantship = from->research_assistantship;
+            this->assistantship_stipend = from->assistantship_stipend;
+            this->teaching_hours = from->teaching_hours;
+            this->research_hours = from->research_hours;
+        }
+    }
+public:
     
-    string getGraduateStudentResearchTopic() { return research_topic; }
+    const string& getGraduateStudentResearchTopic() { return research_topic; }
     Professor* getGraduateStudentAdvisor() { return advisor; }
-    string getGraduateStudentThesisTitle() { return thesis_title; }
+    const string& getGraduateStudentThesisTitle() { return thesis_title; }
     bool getTeachingAssistantship() { return teaching_assistantship; }
     bool getResearchAssistantship() { return research_assistantship; }
     double getAssistantshipStipend() { return assistantship_stipend; }
@@ -637,7 +1476,7 @@ public:
     
     void setGraduateStudentResearchTopic(string research_topic) {
         if (!research_topic.empty()) {
-            this->research_topic = research_topic;
+            this->research_topic = move(research_topic);
             cout << "Graduate Student Research Topic Updated Successfully!\n";
         } else {
             cout << "Research Topic Cannot be Empty!\nResearch Topic not Updated!\n";
@@ -652,7 +1491,7 @@ public:
     
     void setGraduateStudentThesisTitle(string thesis_title) {
         if (!thesis_title.empty()) {
-            this->thesis_title = thesis_title;
+            this->thesis_title = move(thesis_title);
             cout << "Graduate Student Thesis Title Updated Successfully!\n";
         } else {
             cout << "Thesis Title Cannot be Empty!\nThesis Title not Updated!\n";
@@ -668,6 +1507,7 @@ public:
         this->teaching_assistantship = true;
         this->assistantship_stipend += stipend;
         this->teaching_hours = hours;
+        publishPayroll();
         cout << "Teaching Assistantship Assigned Successfully!\n";
     }
     
@@ -679,6 +1519,7 @@ public:
         this->research_assistantship = true;
         this->assistantship_stipend += stipend;
         this->research_hours = hours;
+        publishPayroll();
         cout << "Research Assistantship Assigned Successfully!\n";
     }
     
@@ -690,6 +1531,7 @@ public:
         this->teaching_assistantship = false;
         this->assistantship_stipend -= (assistantship_stipend * teaching_hours) / (teaching_hours + research_hours);
         this->teaching_hours = 0;
+        publishPayroll();
         cout << "Teaching Assistantship Removed Successfully!\n";
     }
     
@@ -701,6 +1543,7 @@ public:
         this->research_assistantship = false;
         this->assistantship_stipend -= (assistantship_stipend * research_hours) / (teaching_hours + research_hours);
         this->research_hours = 0;
+        publishPayroll();
         cout << "Research Assistantship Removed Successfully!\n";
     }
     
@@ -737,11 +1580,18 @@ public:
         }
     }
     
-    double calculatePayment() override {
-        double base_payment = Student::calculatePayment();
-        double assistantship_payment = assistantship_stipend;
+    double calculatePayment(const PaymentContext& context = PaymentContext()) override {
+        return payment(assistantship_stipend, research_assistantship) + context.penalty;
+    }
+
+    PersonKind getPersonKind() override {
+        return KIND_GRADUATE;
+    }
+
+    static double payment(double assistantship_stipend, bool research_assistantship) {
+        double base_payment = Student::BASE_PAYMENT;
         double research_bonus = research_assistantship ? 5000.0 : 0.0;
-        return base_payment + assistantship_payment + research_bonus;
+        return base_payment + assistantship_stipend + research_bonus;
     }
 };
 
@@ -752,12 +1602,26 @@ class AssistantProfessor : public Professor {
         bool promotion_eligible = false;
     public:
         AssistantProfessor() {}
-        AssistantProfessor(string department, string hireDate, string specialization,
-                           int contract_years, int papers_published, bool promotion_eligible) : Professor(department, hireDate, specialization) {
+        AssistantProfessor(const string& department, const string& hireDate, string specialization,
+                           int contract_years, int papers_published, bool promotion_eligible) : Professor(department, hireDate, move(specialization)) {
             this->contract_years = contract_years;
             this->papers_published = papers_published;
             this->promotion_eligible = promotion_eligible;
         }
+        AssistantProfessor(const AssistantProfessor&) = default;
+        AssistantProfessor(AssistantProfessor&&) = default;
+        AssistantProfessor& operator=(const AssistantProfessor& other) { Person::operator=(other); return *this; }
+        AssistantProfessor& operator=(AssistantProfessor&& other) { Person::operator=(move(other)); return *this; }
+    protected:
+        void assignFields(Person& other, bool steal) override {
+            Professor::assignFields(other, steal);
+            if (AssistantProfessor* from = dynamic_cast<AssistantProfessor*>(&other)) {
+                this->contract_years = from->contract_years;
+                this->papers_published = from->papers_published;
+                this->promotion_eligible = from->promotion_eligible;
+            }
+        }
+    public:
         
         int getAssistantProfessorContractYears() { return contract_years; }
         int getAssistantProfessorPapersPublished() { return papers_published; }
@@ -766,6 +1630,7 @@ class AssistantProfessor : public Professor {
         void setAssistantProfessorContractYears(int years) {
             if (years >= 0) {
                 this->contract_years = years;
+                publishPayroll();
                 cout << "Assistant Professor Contract Years Updated Successfully!\n";
             } else {
                 cout << "Contract Years Cannot be Negative!\nContract Years not Updated!\n";
@@ -776,6 +1641,7 @@ class AssistantProfessor : public Professor {
         void setAssistantProfessorPapersPublished(int count) {
             if (count >= 0) {
                 this->papers_published = count;
+                publishPayroll();
                 cout << "Assistant Professor Papers Published Updated Successfully!\n";
             } else {
                 cout << "Papers Published Cannot be Negative!\nPapers Published not Updated!\n";
@@ -785,6 +1651,7 @@ class AssistantProfessor : public Professor {
         
         void setAssistantProfessorPromotionEligible(bool status) {
             this->promotion_eligible = status;
+            publishPayroll();
             cout << "Assistant Professor Promotion Eligibility Updated Successfully!\n";
         }
         
@@ -796,17 +1663,22 @@ class AssistantProfessor : public Professor {
             cout << "Promotion Eligible:\t" << (promotion_eligible ? "Yes" : "No") << '\n';
         }
         
-        double calculatePayment() override {
-            try {
-                double base = Professor::calculatePayment();
-                double paper_bonus = papers_published * 5000;
-                double promotion_bonus = promotion_eligible ? 10000 : 0;
-                double year_multiplier = contract_years > 0 ? contract_years * 0.05 : 0;
-                
-                return base + paper_bonus + promotion_bonus + (base * year_multiplier);
-            } catch (...) {
-                throw PaymentCalculationException(to_string(getPersonID()), 0, "Error calculating assistant professor payment");
-            }
+        double calculatePayment(const PaymentContext& context = PaymentContext()) override {
+            return payment(contract_years, papers_published, promotion_eligible) + context.bonus;
+        }
+
+        PersonKind getPersonKind() override {
+            return KIND_ASSISTANT_PROFESSOR;
+        }
+
+        // Shared with the batch payroll kernels, so the formula lives in one place.
+        static double payment(int contract_years, int papers_published, bool promotion_eligible) {
+            double base = Professor::BASE_PAYMENT;
+            double paper_bonus = papers_published * 5000;
+            double promotion_bonus = promotion_eligible ? 10000 : 0;
+            double year_multiplier = contract_years > 0 ? contract_years * 0.05 : 0;
+            
+            return base + paper_bonus + promotion_bonus + (base * year_multiplier);
         }
     };   
 
@@ -817,12 +1689,26 @@ class AssociateProfessor : public Professor {
             int students_guided = 0;
         public:
             AssociateProfessor() {}
-            AssociateProfessor(string department, string hireDate, string specialization,
-                          int teaching_years, int projects_done, int students_guided) : Professor(department, hireDate, specialization) {
+            AssociateProfessor(const string& department, const string& hireDate, string specialization,
+                          int teaching_years, int projects_done, int students_guided) : Professor(department, hireDate, move(specialization)) {
                 this->teaching_years = teaching_years;
                 this->projects_done = projects_done;
                 this->students_guided = students_guided;
             }
+            AssociateProfessor(const AssociateProfessor&) = default;
+            AssociateProfessor(AssociateProfessor&&) = default;
+            AssociateProfessor& operator=(const AssociateProfessor& other) { Person::operator=(other); return *this; }
+            AssociateProfessor& operator=(AssociateProfessor&& other) { Person::operator=(move(other)); return *this; }
+        protected:
+            void assignFields(Person& other, bool steal) override {
+                Professor::assignFields(other, steal);
+                if (AssociateProfessor* from = dynamic_cast<AssociateProfessor*>(&other)) {
+                    this->teaching_years = from->teaching_years;
+                    this->projects_done = from->projects_done;
+                    this->students_guided = from->students_guided;
+                }
+            }
+        public:
             
             int getAssociateProfessorTeachingYears() { return teaching_years; }
             int getAssociateProfessorProjectsDone() { return projects_done; }
@@ -831,6 +1717,7 @@ class AssociateProfessor : public Professor {
             void setAssociateProfessorTeachingYears(int years) {
                 if (years >= 0) {
                     this->teaching_years = years;
+                    publishPayroll();
                     cout << "Associate Professor Teaching Years Updated Successfully!\n";
                 } else {
                     cout << "Teaching Years Cannot be Negative!\nTeaching Years not Updated!\n";
@@ -841,6 +1728,7 @@ class AssociateProfessor : public Professor {
             void setAssociateProfessorProjectsDone(int projects) {
                 if (projects >= 0) {
                     this->projects_done = projects;
+                    publishPayroll();
                     cout << "Associate Professor Projects Done Updated Successfully!\n";
                 } else {
                     cout << "Projects Done Cannot be Negative!\nProjects Done not Updated!\n";
@@ -851,6 +1739,7 @@ class AssociateProfessor : public Professor {
             void setAssociateProfessorStudentsGuided(int students) {
                 if (students >= 0) {
                     this->students_guided = students;
+                    publishPayroll();
                     cout << "Associate Professor Students Guided Updated Successfully!\n";
                 } else {
                     cout << "Students Guided Cannot be Negative!\nStudents Guided not Updated!\n";
@@ -866,18 +1755,22 @@ class AssociateProfessor : public Professor {
                 cout << "Students Guided:\t" << students_guided << '\n';
             }
             
-            double calculatePayment() override {
-                try {
-                    double base = Professor::calculatePayment();
-                    double year_bonus = teaching_years * 2000;
-                    double project_bonus = projects_done * 10000;
-                    double student_bonus = students_guided * 1000;
-                    double experience_multiplier = teaching_years > 5 ? 0.1 : 0;
-                    
-                    return base + year_bonus + project_bonus + student_bonus + (base * experience_multiplier);
-                } catch (...) {
-                    throw PaymentCalculationException(to_string(getPersonID()), 0, "Error calculating associate professor payment");
-                }
+            double calculatePayment(const PaymentContext& context = PaymentContext()) override {
+                return payment(teaching_years, projects_done, students_guided) + context.bonus;
+            }
+
+            PersonKind getPersonKind() override {
+                return KIND_ASSOCIATE_PROFESSOR;
+            }
+
+            static double payment(int teaching_years, int projects_done, int students_guided) {
+                double base = Professor::BASE_PAYMENT;
+                double year_bonus = teaching_years * 2000;
+                double project_bonus = projects_done * 10000;
+                double student_bonus = students_guided * 1000;
+                double experience_multiplier = teaching_years > 5 ? 0.1 : 0;
+                
+                return base + year_bonus + project_bonus + student_bonus + (base * experience_multiplier);
             }
             
         };    
@@ -889,12 +1782,26 @@ class FullProfessor : public Professor {
                 bool is_head = false;
             public:
                 FullProfessor() {}
-                FullProfessor(string department, string hireDate, string specialization,
-                        int work_years, int foreign_papers, bool is_head) : Professor(department, hireDate, specialization) {
+                FullProfessor(const string& department, const string& hireDate, string specialization,
+                        int work_years, int foreign_papers, bool is_head) : Professor(department, hireDate, move(specialization)) {
                     this->work_years = work_years;
                     this->foreign_papers = foreign_papers;
                     this->is_head = is_head;
                     }
+                FullProfessor(const FullProfessor&) = default;
+                FullProfessor(FullProfessor&&) = default;
+                FullProfessor& operator=(const FullProfessor& other) { Person::operator=(other); return *this; }
+                FullProfessor& operator=(FullProfessor&& other) { Person::operator=(move(other)); return *this; }
+            protected:
+                void assignFields(Person& other, bool steal) override {
+                    Professor::assignFields(other, steal);
+                    if (FullProfessor* from = dynamic_cast<FullProfessor*>(&other)) {
+                        this->work_years = from->work_years;
+                        this->foreign_papers = from->foreign_papers;
+                        this->is_head = from->is_head;
+                    }
+                }
+            public:
                 
                 int getFullProfessorWorkYears() { return work_years; }
                 int getFullProfessorForeignPapers() { return foreign_papers; }
@@ -903,6 +1810,7 @@ class FullProfessor : public Professor {
                 void setFullProfessorWorkYears(int years) {
                     if (years >= 0) {
                         this->work_years = years;
+                        publishPayroll();
                         cout << "Full Professor Work Years Updated Successfully!\n";
                     } else {
                         cout << "Work Years Cannot be Negative!\nWork Years not Updated!\n";
@@ -913,6 +1821,7 @@ class FullProfessor : public Professor {
                 void setFullProfessorForeignPapers(int papers) {
                     if (papers >= 0) {
                         this->foreign_papers = papers;
+                        publishPayroll();
                         cout << "Full Professor Foreign Papers Updated Successfully!\n";
                     } else {
                         cout << "Foreign Papers Cannot be Negative!\nForeign Papers not Updated!\n";
@@ -922,6 +1831,7 @@ class FullProfessor : public Professor {
                 
                 void setFullProfessorIsHead(bool status) {
                     this->is_head = status;
+                    publishPayroll();
                     cout << "Full Professor Head Status Updated Successfully!\n";
                 }
                 
@@ -933,747 +1843,5780 @@ class FullProfessor : public Professor {
                     cout << "Is Head:\t" << (is_head ? "Yes" : "No") << '\n';
                 }
                 
-                double calculatePayment() override {
-                    try {
-                        double base = Professor::calculatePayment();
-                        double year_bonus = work_years * 5000;
-                        double paper_bonus = foreign_papers * 1000;
-                        double head_bonus = is_head ? 50000 : 0;
-                        double seniority_multiplier = work_years > 10 ? 0.2 : 0;
-                        
-                        return base + year_bonus + paper_bonus + head_bonus + (base * seniority_multiplier);
-                    } catch (...) {
-                        throw PaymentCalculationException(to_string(getPersonID()), 0, "Error calculating full professor payment");
-                    }
+                double calculatePayment(const PaymentContext& context = PaymentContext()) override {
+                    return payment(work_years, foreign_papers, is_head) + context.bonus;
+                }
+
+                PersonKind getPersonKind() override {
+                    return KIND_FULL_PROFESSOR;
+                }
+
+                static double payment(int work_years, int foreign_papers, bool is_head) {
+                    double base = Professor::BASE_PAYMENT;
+                    double year_bonus = work_years * 5000;
+                    double paper_bonus = foreign_papers * 1000;
+                    double head_bonus = is_head ? 50000 : 0;
+                    double seniority_multiplier = work_years > 10 ? 0.2 : 0;
+                    
+                    return base + year_bonus + paper_bonus + head_bonus + (base * seniority_multiplier);
                 }
             };
             
 
-class Course{
-                private:
-                    string code = "", title = "", description = "";
-                    double credits = 0;
-                    Professor* instructor = nullptr;
-                    vector<Student*> enrolled_students;
-                    int max_capacity = 30;
-                    string enrollment_deadline = "31/12/23";
-                public:
-                    Course(){}
-                    Course(string code, string title, string description, double credits, int max_capacity = 30){
-                        this->code = code;
-                        this->title = title;
-                        this->description = description;
-                        this->credits = credits;
-                        this->max_capacity = max_capacity;
-                    }
-                
-                    string getCourseCode() {return code;}
-                    string getCourseTitle() {return title;}
-                    string getCourseDescription() {return description;}
-                    double getCourseCredits() {return credits;}
-                    Professor* getCourseInstructor() {return instructor;}
-                    vector<Student*> getEnrolledStudents() {return enrolled_students;}
-                    int getMaxCapacity() {return max_capacity;}
-                    string getEnrollmentDeadline() {return enrollment_deadline;}
-                
-                    void setCourseCode(string code) {
-                        if (!code.empty()) {
-                            this->code = code;
-                            cout << "Course Code Updated Successfully!\n";
-                        } else {
-                            cout << "Course Code Cannot be Empty!\nCode not Updated!\n";
-                            return;
-                        }
-                    }
-                    
-                    void setCourseTitle(string title){
-                        if (!title.empty()) {
-                            this->title = title;
-                            cout << "Course Title Updated Successfully!\n";
-                        } else {
-                            cout << "Course Title Cannot be Empty!\nTitle not Updated!\n";
-                            return;
-                        }
-                    }
-                    
-                    void setCourseDescription(string description){
-                        this->description = description;
-                        cout << "Course Description Updated Successfully!\n";
-                    }
-                    
-                    void setCourseCredits(double credits){
-                        if (credits > 0){
-                            this->credits = credits;
-                            cout << "Course Credits Updated Successfully!\n";
-                        }
-                        else {
-                            cout << "Credits Must be Positive!\nCourse Credits Not Updated!\n";
-                            return;
-                        }
-                    }
-                    
-                    void setMaxCapacity(int capacity) {
-                        if (capacity > 0) {
-                            this->max_capacity = capacity;
-                            cout << "Course Maximum Capacity Updated Successfully!\n";
-                        } else {
-                            cout << "Capacity Must be Positive!\nCapacity not Updated!\n";
-                            return;
-                        }
-                    }
-                    
-                    void setEnrollmentDeadline(string deadline) {
-                        if (dateValidator(deadline)) {
-                            this->enrollment_deadline = deadline;
-                            cout << "Course Enrollment Deadline Updated Successfully!\n";
-                        } else {
-                            cout << "Date Format Invalid!\nEnrollment Deadline not Updated!\n";
-                            return;
-                        }
-                    }
-                    
-                    void setInstructor(Professor* professor) {
-                        this->instructor = professor;
-                        cout << "Course Instructor Set Successfully!\n";
-                    }
-                    
-                    void enrollStudent(Student* student, string current_date) {
-                        try {
-                            if (enrolled_students.size() >= max_capacity) {
-                                throw CourseFullException(to_string(student->getPersonID()), code, max_capacity, enrolled_students.size());
-                            }
-                            
-                            if (!dateValidator(current_date)) {
-                                throw EnrollmentException("Invalid current date format", to_string(student->getPersonID()), code, 102);
-                            }
-                            
-                            if (current_date > enrollment_deadline) {
-                                throw EnrollmentDeadlineException(to_string(student->getPersonID()), code, enrollment_deadline, current_date);
-                            }
-                            
-                            for (auto s : enrolled_students) {
-                                if (s->getPersonID() == student->getPersonID()) {
-                                    cout << "Student Already Enrolled in this Course!\n";
-                                    return;
-                                }
-                            }
-                            
-                            enrolled_students.push_back(student);
-                            cout << "Student Enrolled in Course Successfully!\n";
-                        } catch (const UniversitySystemException& e) {
-                            cout << "Enrollment Error: " << e.what() << endl;
-                            cout << e.getDetails() << endl;
-                            writeToErrorLog(e.getDetails());
-                        }
-                    }
-                    
-                    void dropStudent(int studentID) {
-                        try {
-                            for (int i = 0; i < enrolled_students.size(); i++) {
-                                if (enrolled_students[i]->getPersonID() == studentID) {
-                                    enrolled_students.erase(enrolled_students.begin() + i);
-                                    cout << "Student Dropped from Course Successfully!\n";
-                                    return;
-                                }
-                            }
-                            throw EnrollmentException("Student not found in course", to_string(studentID), code, 104);
-                        } catch (const UniversitySystemException& e) {
-                            cout << "Drop Student Error: " << e.what() << endl;
-                            cout << e.getDetails() << endl;
-                            writeToErrorLog(e.getDetails());
-                        }
-                    }
-                    
-                    void displayCourseDetails() {
-                        cout << "Course Details:\n";
-                        cout << "Code: " << code << "\n";
-                        cout << "Title: " << title << "\n";
-                        cout << "Description: " << description << "\n";
-                        cout << "Credits: " << credits << "\n";
-                        cout << "Max Capacity: " << max_capacity << "\n";
-                        cout << "Enrollment Deadline: " << enrollment_deadline << "\n";
-                        
-                        if (instructor != nullptr) {
-                            cout << "Instructor: " << instructor->getPersonName() << "\n";
-                        } else {
-                            cout << "No Instructor Assigned\n";
-                        }
-                        
-                        cout << "Enrolled Students: " << enrolled_students.size() << "\n";
-                    }
-                
-                    void displayEnrolledStudents() {
-                        if (enrolled_students.empty()) {
-                            cout << "No Students Enrolled in this Course!\n";
-                            return;
-                        }
-                        cout << "Students Enrolled in " << title << ":\n";
-                        for (auto student : enrolled_students) {
-                            cout << "ID: " << student->getPersonID() << ", Name: " << student->getPersonName() << "\n";
-                        }
-                    }
-                    
-                    void writeToErrorLog(const string& errorDetails) {
-                        ofstream logFile("university_system_error.log", ios::app);
-                        if (logFile.is_open()) {
-                            time_t now = time(0);
-                            char* dt = ctime(&now);
-                            logFile << "[" << dt << "] " << errorDetails << endl;
-                            logFile.close();
-                        } else {
-                            cout << "Warning: Unable to open error log file!" << endl;
-                        }
-                    }
-                };
-
-class Department{
+// Same-type objects in fixed-size blocks. Blocks never move, so a pointer
+// from create() stays valid until that object is destroyed; freed slots are
+// reused, and clear() destroys everything left in one sweep. Objects in a
+// block are packed back to back and their live flags sit in a bitmap after
+// them, so iterating a pool walks objects in memory order and only reads the
+// objects that are live.
+template <typename T, size_t BLOCK_SIZE = 1024>
+class ObjectPool {
 private:
-    string name = "", location = "";
-    double budget;
-    vector<Professor*> professors;
-public:
-    Department(){}
-    Department(string name, string location, double budget){
-        this->name = name;
-        this->location = location;
-        this->budget = budget;
-    }
+    static_assert(BLOCK_SIZE % 64 == 0, "live bitmap covers whole 64-bit words");
+    static constexpr size_t WORDS = BLOCK_SIZE / 64;
 
-    string getDepartmentName() {return name;}
-    string getDepartmentLocation() {return location;}
-    double getDepartmentBudget() {return budget;}
-    vector<Professor*> getDepartmentProfessors() {return professors;}
+    struct Block {
+        alignas(T) unsigned char storage[BLOCK_SIZE * sizeof(T)];
+        uint64_t live[WORDS] = {};
 
-    void setDepartmentName(string name) {
-        this->name = name;
-        cout << "Department Name Updated Successfully!\n";
-    }
-    void setDepartmentLocation(string location){
-        this->location = location;
-        cout << "Department Location Updated Successfully!\n";
-    } 
-    void setDepartmentBudget(double budget){
-        if (budget>0) {
-            this->budget = budget;
-            cout << "Department Budget Updated Successfully!\n";
+        T* at(size_t i) { return reinterpret_cast<T*>(storage) + i; }
+    };
+    vector<Block*> blocks;
+    // The same blocks sorted by address, to find the block of a T*.
+    vector<Block*> by_address;
+    vector<T*> free_slots;
+    size_t filled_blocks = 0;
+    size_t next_fresh = BLOCK_SIZE;
+    size_t live_count = 0;
+
+    // A free slot and the block it is in.
+    T* takeSlot(Block*& block) {
+        if (!free_slots.empty()) {
+            T* slot = free_slots.back();
+            free_slots.pop_back();
+            block = blockOf(slot);
+            return slot;
         }
-        else {
-            cout << "Budget Should be greater then 0!\n Budget not Updated!"; return;
+        if (next_fresh == BLOCK_SIZE) {
+            if (filled_blocks == blocks.size()) {
+                // Not new Block(): that would zero the object storage too.
+                Block* block = new Block;
+                blocks.push_back(block);
+                by_address.insert(upper_bound(by_address.begin(), by_address.end(), block, less<Block*>()), block);
+            }
+            filled_blocks++;
+            next_fresh = 0;
         }
+        block = blocks[filled_blocks - 1];
+        return block->at(next_fresh++);
     }
-    void addProfessor(Professor* professor) {
-        professors.push_back(professor);
-        cout << "Professor Added to Department Successfully!\n";
+
+    // The block holding object, or nullptr if it is not from this pool.
+    Block* blockOf(T* object) {
+        auto after = upper_bound(by_address.begin(), by_address.end(), object,
+                                 [](T* object, Block* block) { return less<const void*>()(object, block); });
+        if (after == by_address.begin()) return nullptr;
+        Block* block = *(after - 1);
+        return object < block->at(BLOCK_SIZE) ? block : nullptr;
     }
 
-    void removeProfessor(int professorID) {
-        for (int i = 0; i < professors.size(); i++) {
-            if (professors[i]->getPersonID() == professorID) {
-                professors.erase(professors.begin() + i);
-                cout << "Professor Removed from Department Successfully!\n";
-                return;
-            }
+    // Calls visit(first, count) for each run of consecutive live objects in
+    // block, lowest address first. Bits past the last used slot are never set.
+    template <typename Visitor>
+    static void forEachRunIn(Block* block, Visitor& visit) {
+        size_t i = 0;
+        while (i < BLOCK_SIZE) {
+            size_t w = i / 64;
+            uint64_t bits = block->live[w] & (~0ULL << (i % 64));
+            while (bits == 0 && ++w < WORDS) bits = block->live[w];
+            if (w == WORDS) return;
+            size_t start = w * 64 + __builtin_ctzll(bits);
+            uint64_t dead = ~block->live[w] & (~0ULL << (start % 64));
+            while (dead == 0 && ++w < WORDS) dead = ~block->live[w];
+            size_t end = w == WORDS ? BLOCK_SIZE : w * 64 + __builtin_ctzll(dead);
+            visit(block->at(start), end - start);
+            i = end;
         }
-        cout << "Professor Not Found in Department!\n";
+    }
+public:
+    ObjectPool() {}
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+    ~ObjectPool() {
+        release();
     }
 
-    void displayProfessors() {
-        if (professors.empty()) {
-            cout << "No Professors in this Department!\n";
-            return;
-        }
-        cout << "Professors in Department " << name << ":\n";
-        for (auto prof : professors) {
-            prof->displayDetails();
-            cout << "------------------------\n";
+    template <typename... Args>
+    T* create(Args&&... args) {
+        Block* block;
+        T* slot = takeSlot(block);
+        T* object;
+        try {
+            object = new (slot) T(forward<Args>(args)...);
+        } catch (...) {
+            free_slots.push_back(slot);
+            throw;
         }
+        size_t i = object - block->at(0);
+        block->live[i / 64] |= 1ULL << (i % 64);
+        live_count++;
+        return object;
     }
-};
 
+    void destroy(T* object) {
+        Block* block = object == nullptr ? nullptr : blockOf(object);
+        if (block == nullptr) return;
+        size_t i = object - block->at(0);
+        uint64_t bit = 1ULL << (i % 64);
+        if ((block->live[i / 64] & bit) == 0) return;
+        object->~T();
+        block->live[i / 64] &= ~bit;
+        free_slots.push_back(object);
+        live_count--;
+    }
 
+    // Calls visit(first, count) for each run of live objects that sit next
+    // to each other. A scan that keeps its running state in locals inside
+    // visit gets a plain array loop over each run.
+    template <typename Visitor>
+    void forEachRun(Visitor visit) {
+        for (size_t b = 0; b < filled_blocks; b++) forEachRunIn(blocks[b], visit);
+    }
 
-class GradeBook{
-private:
-    map<string, int> studentGrades;
-    string courseCode = "";
-public:
-    GradeBook(){}
+    template <typename Visitor>
+    void forEach(Visitor visit) {
+        forEachRun([&visit](T* first, size_t count) {
+            for (size_t i = 0; i < count; i++) visit(first[i]);
+        });
+    }
 
-    void addGrade(string ID, int Grade){
-        if (Grade <= 100 && Grade >= 0){
-            studentGrades[ID] = Grade;
-            cout << "Grade of Student ID: " << ID << " Updated Successfully!\n";
-        } else {
-            cout << "Invalid Grades!\n Student Grade Not Updated!\n";
-            return;
+    // Destroys every object but keeps the blocks, so refilling the pool
+    // does not go back to the system allocator.
+    void clear() {
+        for (size_t b = 0; b < filled_blocks; b++) {
+            Block* block = blocks[b];
+            auto destroyRun = [](T* first, size_t count) {
+                for (size_t i = 0; i < count; i++) first[i].~T();
+            };
+            if (!is_trivially_destructible<T>::value) forEachRunIn(block, destroyRun);
+            fill(begin(block->live), end(block->live), 0);
         }
+        free_slots.clear();
+        filled_blocks = 0;
+        next_fresh = BLOCK_SIZE;
+        live_count = 0;
     }
 
-    double averageGrade(){
-        if (studentGrades.empty()){ return 0;}
+    // clear(), then hands the blocks back as well.
+    void release() {
+        clear();
+        for (auto block : blocks) delete block;
+        blocks.clear();
+        by_address.clear();
+    }
 
-        double sum = 0;
-        for (auto s : studentGrades){
-            sum += s.second;
-        }
+    size_t size() const {
+        return live_count;
+    }
 
-        return sum/studentGrades.size();
+    size_t capacity() const {
+        return blocks.size() * BLOCK_SIZE;
     }
+};
 
-    int HighestMarks(){
-        if (studentGrades.empty()) return 0;
-        int max = INT_MIN;
-        for (auto p : studentGrades){
-            if (max < p.second) max = p.second;
-        }
+// One ObjectPool per concrete Person type, so people of a type are stored
+// next to each other. destroy(Person*) routes by getPersonKind().
+class PersonPool {
+private:
+    tuple<ObjectPool<Person>, ObjectPool<Student>, ObjectPool<UndergraduateStudent>, ObjectPool<GraduateStudent>,
+          ObjectPool<Professor>, ObjectPool<AssistantProfessor>, ObjectPool<AssociateProfessor>, ObjectPool<FullProfessor>> pools;
+public:
+    PersonPool() {}
+    PersonPool(const PersonPool&) = delete;
+    PersonPool& operator=(const PersonPool&) = delete;
 
-        return max;
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        return get<ObjectPool<T>>(pools).create(forward<Args>(args)...);
     }
 
-    vector<string> failingStudents(double PassMarks = 33.5){
-        if (studentGrades.empty()) return {};
-        vector<string> results;
+    template <typename T>
+    ObjectPool<T>& of() {
+        return get<ObjectPool<T>>(pools);
+    }
 
-        for (auto p : studentGrades){
-            if (p.second < PassMarks){
-                results.push_back(p.first);
-            }
+    void destroy(Person* person) {
+        if (person == nullptr) return;
+        switch (person->getPersonKind()) {
+            case KIND_PERSON: of<Person>().destroy(person); break;
+            case KIND_STUDENT: of<Student>().destroy(static_cast<Student*>(person)); break;
+            case KIND_UNDERGRADUATE: of<UndergraduateStudent>().destroy(static_cast<UndergraduateStudent*>(person)); break;
+            case KIND_GRADUATE: of<GraduateStudent>().destroy(static_cast<GraduateStudent*>(person)); break;
+            case KIND_PROFESSOR: of<Professor>().destroy(static_cast<Professor*>(person)); break;
+            case KIND_ASSISTANT_PROFESSOR: of<AssistantProfessor>().destroy(static_cast<AssistantProfessor*>(person)); break;
+            case KIND_ASSOCIATE_PROFESSOR: of<AssociateProfessor>().destroy(static_cast<AssociateProfessor*>(person)); break;
+            case KIND_FULL_PROFESSOR: of<FullProfessor>().destroy(static_cast<FullProfessor*>(person)); break;
+            default: break;
         }
+    }
 
-        return results;
+    // Visits every person, one type at a time.
+    template <typename Visitor>
+    void forEach(Visitor visit) {
+        of<Person>().forEach(visit);
+        of<Student>().forEach(visit);
+        of<UndergraduateStudent>().forEach(visit);
+        of<GraduateStudent>().forEach(visit);
+        of<Professor>().forEach(visit);
+        of<AssistantProfessor>().forEach(visit);
+        of<AssociateProfessor>().forEach(visit);
+        of<FullProfessor>().forEach(visit);
     }
 
-    void showGrades(){
-        if (studentGrades.empty()){
-            cout << "Empty Grades!\n";
-            return;
-        }
+    size_t size() {
+        size_t total = 0;
+        forEachPool([&total](auto& pool) { total += pool.size(); });
+        return total;
+    }
 
-        cout << "Student ID\tGrades\n";
-        for (auto p : studentGrades){
-            cout << p.first << '\t' << p.second << '\n';
-        }
+    void clear() {
+        forEachPool([](auto& pool) { pool.clear(); });
     }
-};
 
-class EnrollmentManager{
+    void release() {
+        forEachPool([](auto& pool) { pool.release(); });
+    }
 private:
-    map<string, vector<string>> enrolledStudents;
+    template <typename Visitor>
+    void forEachPool(Visitor visit) {
+        visit(of<Person>());
+        visit(of<Student>());
+        visit(of<UndergraduateStudent>());
+        visit(of<GraduateStudent>());
+        visit(of<Professor>());
+        visit(of<AssistantProfessor>());
+        visit(of<AssociateProfessor>());
+        visit(of<FullProfessor>());
+    }
+};
+
+// Runs payroll one concrete type at a time instead of one virtual call per
+// person. load() puts each person in the group for their kind, and each group
+// keeps only the columns its formula reads. run() fills every group's amount
+// column in a straight loop over those columns, then totals the amounts by
+// kind and by department. Professors are counted under their department and
+// students under their program.
+class PayrollEngine {
 public:
-    EnrollmentManager(){}
+    struct DepartmentTotal {
+        string name;
+        size_t people = 0;
+        double total = 0;
+    };
 
-    void enrollStudent(string courseCode, string ID){
-        if (enrolledStudents.find(courseCode) != enrolledStudents.end()){
-            for (auto c : enrolledStudents[courseCode]){
-                if (c==ID){
-                    cout << "Student Already Enrolled!\n";
-                    return;
-                }
+    struct Report {
+        size_t people = 0;
+        double total = 0;
+        size_t kind_counts[PERSON_KIND_COUNT] = {};
+        double kind_totals[PERSON_KIND_COUNT] = {};
+        vector<DepartmentTotal> departments;
+        double seconds = 0;
+
+        void display() {
+            static const char* names[PERSON_KIND_COUNT] = {"Person", "Student", "Undergraduate Student", "Graduate Student", "Professor",
+                                                           "Assistant Professor", "Associate Professor", "Full Professor"};
+            ios::fmtflags flags = cout.flags();
+            streamsize precision = cout.precision(2);
+            cout << fixed;
+            cout << "Payroll for " << people << " People: " << total << "\n";
+            for (int kind = 0; kind < PERSON_KIND_COUNT; kind++) {
+                if (kind_counts[kind] > 0) cout << names[kind] << " (" << kind_counts[kind] << "):\t" << kind_totals[kind] << "\n";
+            }
+            cout << "By Department:\n";
+            for (auto& department : departments) {
+                cout << department.name << " (" << department.people << "):\t" << department.total << "\n";
             }
+            cout.flags(flags);
+            cout.precision(precision);
         }
-        enrolledStudents[courseCode].push_back(ID);
-        cout << "Student of Student ID: " << ID << " enrolled in courseCode: " << courseCode << " succesfully!\n";
+    };
+private:
+    // Field columns, used per kind as:
+    //   graduate   stipend, flag = research assistantship
+    //   assistant  years = contract years, count = papers published, flag = promotion eligible
+    //   associate  years = teaching years, count = projects done, extra = students guided
+    //   full       years = work years, count = foreign papers, flag = is head
+    struct Group {
+        vector<uint32_t> department;
+        vector<int> years, count, extra;
+        vector<double> stipend;
+        vector<uint8_t> flag;
+        vector<double> amount;
+    };
+    Group groups[PERSON_KIND_COUNT];
+    vector<string> department_names;
+    // Department symbol -> position in department_names, UINT32_MAX when not seen yet.
+    vector<uint32_t> department_index;
+
+    uint32_t departmentOf(uint32_t symbol) {
+        if (symbol >= department_index.size()) department_index.resize(max((size_t)symbol + 1, department_index.size() * 2), UINT32_MAX);
+        uint32_t& index = department_index[symbol];
+        if (index == UINT32_MAX) {
+            index = department_names.size();
+            department_names.push_back(symbol == 0 ? "Unassigned" : symbolText(symbol));
+        }
+        return index;
     }
 
-    void dropStudent(string courseCode, string ID){
-        if (enrolledStudents.find(courseCode) != enrolledStudents.end()){
-            if (find(enrolledStudents[courseCode].begin(), enrolledStudents[courseCode].end(), ID) != enrolledStudents[courseCode].end()){
-                auto& vec = enrolledStudents[courseCode];
-                vec.erase(remove(vec.begin(), vec.end(), ID), vec.end());
-                cout << "Student Removed Successfully!\n";
-                return;
-            } else {
-                cout << "Student Already Not Enrolled!\n"; return;
-            }
-        } else {
-            cout << "Course Not Found!\n";
-            return;
+    void computeAmounts(int kind) {
+        Group& group = groups[kind];
+        size_t n = group.department.size();
+        group.amount.resize(n);
+        double* amount = group.amount.data();
+        const int* years = group.years.data();
+        const int* count = group.count.data();
+        const int* extra = group.extra.data();
+        const double* stipend = group.stipend.data();
+        const uint8_t* flag = group.flag.data();
+        switch (kind) {
+            case KIND_PERSON:
+                for (size_t i = 0; i < n; i++) amount[i] = 0;
+                break;
+            case KIND_STUDENT:
+                for (size_t i = 0; i < n; i++) amount[i] = Student::BASE_PAYMENT;
+                break;
+            case KIND_UNDERGRADUATE:
+                for (size_t i = 0; i < n; i++) amount[i] = UndergraduateStudent::payment();
+                break;
+            case KIND_GRADUATE:
+                for (size_t i = 0; i < n; i++) amount[i] = GraduateStudent::payment(stipend[i], flag[i]);
+                break;
+            case KIND_PROFESSOR:
+                for (size_t i = 0; i < n; i++) amount[i] = Professor::BASE_PAYMENT;
+                break;
+            case KIND_ASSISTANT_PROFESSOR:
+                for (size_t i = 0; i < n; i++) amount[i] = AssistantProfessor::payment(years[i], count[i], flag[i]);
+                break;
+            case KIND_ASSOCIATE_PROFESSOR:
+                for (size_t i = 0; i < n; i++) amount[i] = AssociateProfessor::payment(years[i], count[i], extra[i]);
+                break;
+            case KIND_FULL_PROFESSOR:
+                for (size_t i = 0; i < n; i++) amount[i] = FullProfessor::payment(years[i], count[i], flag[i]);
+                break;
         }
     }
+public:
+    PayrollEngine() {}
+
+    void clear() {
+        for (auto& group : groups) group = Group();
+        department_names.clear();
+        department_index.clear();
+    }
+
+    void add(Person* person) {
+        PersonKind kind = person->getPersonKind();
+        Group& group = groups[kind];
+        group.department.push_back(departmentOf(payrollDepartment(person)));
 
-    int getEnrollmentCount(string courseCode){
-        if (enrolledStudents.find(courseCode) != enrolledStudents.end()){
-            return enrolledStudents[courseCode].size();
+        if (kind == KIND_GRADUATE) {
+            GraduateStudent* graduate = static_cast<GraduateStudent*>(person);
+            group.stipend.push_back(graduate->getAssistantshipStipend());
+            group.flag.push_back(graduate->getResearchAssistantship());
+        } else if (kind == KIND_ASSISTANT_PROFESSOR) {
+            AssistantProfessor* assistant = static_cast<AssistantProfessor*>(person);
+            group.years.push_back(assistant->getAssistantProfessorContractYears());
+            group.count.push_back(assistant->getAssistantProfessorPapersPublished());
+            group.flag.push_back(assistant->getAssistantProfessorPromotionEligible());
+        } else if (kind == KIND_ASSOCIATE_PROFESSOR) {
+            AssociateProfessor* associate = static_cast<AssociateProfessor*>(person);
+            group.years.push_back(associate->getAssociateProfessorTeachingYears());
+            group.count.push_back(associate->getAssociateProfessorProjectsDone());
+            group.extra.push_back(associate->getAssociateProfessorStudentsGuided());
+        } else if (kind == KIND_FULL_PROFESSOR) {
+            FullProfessor* full = static_cast<FullProfessor*>(person);
+            group.years.push_back(full->getFullProfessorWorkYears());
+            group.count.push_back(full->getFullProfessorForeignPapers());
+            group.flag.push_back(full->getFullProfessorIsHead());
         }
-        return 0;
     }
 
-    vector<string> getEnrolledStudents(string courseCode){
-        vector<string> result;
+    void load(const vector<Person*>& people) {
+        clear();
+        for (auto person : people) add(person);
+    }
 
-        if (enrolledStudents.find(courseCode) != enrolledStudents.end()){
-            for (auto c : enrolledStudents[courseCode]){
-                result.push_back(c);
+    Report run() {
+        Report report;
+        auto start = chrono::steady_clock::now();
+        vector<DepartmentTotal> departments(department_names.size());
+        for (int kind = 0; kind < PERSON_KIND_COUNT; kind++) {
+            computeAmounts(kind);
+            const Group& group = groups[kind];
+            double kind_total = 0;
+            for (size_t i = 0; i < group.amount.size(); i++) {
+                DepartmentTotal& department = departments[group.department[i]];
+                department.people++;
+                department.total += group.amount[i];
+                kind_total += group.amount[i];
             }
-        }   
-        else return {};
-        return result;
+            report.kind_counts[kind] = group.amount.size();
+            report.kind_totals[kind] = kind_total;
+            report.people += group.amount.size();
+            report.total += kind_total;
+        }
+        for (size_t d = 0; d < departments.size(); d++) departments[d].name = department_names[d];
+        sort(departments.begin(), departments.end(), [](const DepartmentTotal& a, const DepartmentTotal& b) { return a.name < b.name; });
+        report.departments = move(departments);
+        report.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return report;
     }
 
+    Report run(const vector<Person*>& people) {
+        load(people);
+        return run();
+    }
 };
 
-
-class University {
-private:
-    string name = "";
-    string location = "";
-    vector<Department*> departments;
+// Append-only redo log for enrollment and grade changes. Each record is
+// [payload length][CRC-32 of payload][payload]. append() only buffers; commit()
+// waits until a record is on disk. Whichever committer finds no flush running
+// writes everything buffered so far and calls fdatasync once for the batch.
+// Under contention that committer first waits up to GROUP_WINDOW for the
+// other threads to append, so one fdatasync covers a record from each.
+class WriteAheadLog {
 public:
-    University() {}
-    University(string name, string location) {
-        this->name = name;
-        this->location = location;
+    enum RecordType : uint8_t { COURSE_ENROLL = 1, COURSE_DROP, MANAGER_ENROLL, MANAGER_DROP, GRADE, WAITLIST_JOIN, WAITLIST_LEAVE };
+private:
+    int fd = -1;
+    string path;
+    mutex lock;
+    condition_variable flushed;
+    string pending;
+    size_t pendingRecords = 0;
+    condition_variable appended;
+    uint64_t nextLSN = 1;
+    uint64_t durableLSN = 0;
+    bool flushing = false;
+    // Set when a batch could not be written. Nothing after durableLSN is known
+    // to be on disk, so every later commit fails too.
+    bool failed = false;
+    uint64_t batchCount = 0, recordCount = 0;
+    // Committers blocked behind the running flush; they append again right
+    // after it, which is what the next batch waits for.
+    size_t waitingCommitters = 0, lastBatchRecords = 0;
+    static constexpr chrono::microseconds GROUP_WINDOW{200};
+    static constexpr size_t MAX_BATCH_RECORDS = 256;
+
+    static void putInt(string& out, uint32_t value) {
+        out.append((const char*)&value, sizeof(value));
     }
-    
-    string getUniversityName() { return name; }
-    string getUniversityLocation() { return location; }
-    vector<Department*> getUniversityDepartments() { return departments; }
-    
-    void setUniversityName(string name) {
-        if (!name.empty()) {
-            this->name = name;
-            cout << "University Name Updated Successfully!\n";
-        } else {
-            cout << "University Name Cannot be Empty!\nName not Updated!\n";
+
+    static bool getInt(const char*& at, const char* end, uint32_t& value) {
+        if (end - at < (ptrdiff_t)sizeof(value)) return false;
+        memcpy(&value, at, sizeof(value));
+        at += sizeof(value);
+        return true;
+    }
+
+    static bool getString(const char*& at, const char* end, string& value) {
+        uint32_t length;
+        if (!getInt(at, end, length) || (uint64_t)(end - at) < length) return false;
+        value.assign(at, length);
+        at += length;
+        return true;
+    }
+
+    static bool writeAll(int fd, const string& data) {
+        size_t written = 0;
+        while (written < data.size()) {
+            ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) return false;
+            written += n;
         }
+        return true;
     }
-    
-    void setUniversityLocation(string location) {
-        if (!location.empty()) {
-            this->location = location;
-            cout << "University Location Updated Successfully!\n";
-        } else {
-            cout << "University Location Cannot be Empty!\nLocation not Updated!\n";
+public:
+    WriteAheadLog() {}
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+    // Destructors must not throw, so a failed final flush is only reported.
+    ~WriteAheadLog() {
+        try {
+            close();
+        } catch (const UniversitySystemException& e) {
+            cout << "Write-Ahead Log Not Flushed on Close: " << e.getDetails() << endl;
         }
     }
-    
-    void addDepartment(Department* department) {
-        departments.push_back(department);
-        cout << "Department Added to University Successfully!\n";
+
+    static uint32_t crc32(const char* data, size_t length) {
+        static const vector<uint32_t> table = []() {
+            vector<uint32_t> entries(256);
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                entries[i] = c;
+            }
+            return entries;
+        }();
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < length; i++) crc = table[(crc ^ (uint8_t)data[i]) & 0xFF] ^ (crc >> 8);
+        return crc ^ 0xFFFFFFFFu;
     }
-    
-    void removeDepartment(string departmentName) {
-        for (int i = 0; i < departments.size(); i++) {
-            if (departments[i]->getDepartmentName() == departmentName) {
-                departments.erase(departments.begin() + i);
-                cout << "Department Removed from University Successfully!\n";
-                return;
-                }
+
+    // Starts a fresh log. Records left unflushed by a failed log are dropped;
+    // none of them was reported durable.
+    bool open(const string& path) {
+        try {
+            close();
+        } catch (const UniversitySystemException&) {
         }
-        cout << "Department Not Found in University!\n";
+        lock_guard<mutex> guard(lock);
+        pending.clear();
+        pendingRecords = 0;
+        durableLSN = nextLSN - 1;
+        failed = false;
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        this->path = path;
+        return fd >= 0;
+    }
+
+    // Throws if the final flush fails; the file is closed either way.
+    void close() {
+        if (fd < 0) return;
+        bool ok = tryCommit(nextLSN - 1);
+        ::close(fd);
+        fd = -1;
+        if (!ok) throw UniversitySystemException("Failed to write log " + path, 610);
+    }
+
+    uint64_t getBatchCount() { lock_guard<mutex> guard(lock); return batchCount; }
+    uint64_t getRecordCount() { lock_guard<mutex> guard(lock); return recordCount; }
+
+    // Buffers a record and returns its log sequence number.
+    uint64_t append(RecordType type, const string& courseCode, const string& ID, int value = 0) {
+        string payload;
+        payload.reserve(13 + courseCode.size() + ID.size());
+        payload.push_back((char)type);
+        putInt(payload, courseCode.size());
+        payload += courseCode;
+        putInt(payload, ID.size());
+        payload += ID;
+        putInt(payload, (uint32_t)value);
+
+        lock_guard<mutex> guard(lock);
+        putInt(pending, payload.size());
+        putInt(pending, crc32(payload.data(), payload.size()));
+        pending += payload;
+        recordCount++;
+        if (++pendingRecords >= min(lastBatchRecords, MAX_BATCH_RECORDS)) appended.notify_one();
+        return nextLSN++;
+    }
+
+    // Returns true once every record up to lsn is durable, false if the log
+    // failed first. A batch that was only partly written cannot be retried
+    // safely, so a failure is permanent and durableLSN never moves past it.
+    bool tryCommit(uint64_t lsn) {
+        unique_lock<mutex> guard(lock);
+        while (durableLSN < lsn) {
+            if (failed) return false;
+            if (flushing) {
+                waitingCommitters++;
+                flushed.wait(guard);
+                waitingCommitters--;
+                continue;
+            }
+            flushing = true;
+            // The last batch was shared, so its committers are about to append
+            // again; give them a moment to join this one.
+            if (lastBatchRecords > 1) {
+                appended.wait_for(guard, GROUP_WINDOW, [this]() {
+                    return pendingRecords >= min(lastBatchRecords, MAX_BATCH_RECORDS);
+                });
+            }
+            string batch;
+            batch.swap(pending);
+            size_t batchRecords = pendingRecords;
+            pendingRecords = 0;
+            uint64_t batchEnd = nextLSN - 1;
+            guard.unlock();
+            bool ok = writeAll(fd, batch) && fdatasync(fd) == 0;
+            guard.lock();
+            flushing = false;
+            flushed.notify_all();
+            if (!ok) {
+                failed = true;
+                return false;
+            }
+            durableLSN = batchEnd;
+            batchCount++;
+            lastBatchRecords = max(batchRecords, waitingCommitters + 1);
+        }
+        return true;
+    }
+
+    void commit(uint64_t lsn) {
+        if (!tryCommit(lsn)) {
+            cout << "Write-Ahead Log Write Failed!\n";
+            throw UniversitySystemException("Failed to write log " + path, 610);
+        }
+    }
+
+    bool hasFailed() { lock_guard<mutex> guard(lock); return failed; }
+
+    // Drops every record; call right after a snapshot has captured their effect.
+    void reset() {
+        commit(nextLSN - 1);
+        lock_guard<mutex> guard(lock);
+        if (ftruncate(fd, 0) != 0 || fdatasync(fd) != 0) {
+            throw UniversitySystemException("Failed to truncate log " + path, 610);
+        }
+    }
+
+    // Calls apply(type, courseCode, ID, value) for each intact record in order.
+    // Stops at the first torn or corrupt record and cuts the file there so new
+    // appends do not land behind garbage. Returns the number of records read.
+    static size_t replay(const string& path, function<void(RecordType, const string&, const string&, int)> apply, bool& tornTail) {
+        tornTail = false;
+        ifstream in(path, ios::binary);
+        if (!in.is_open()) return 0;
+        string data((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        in.close();
+
+        const char* at = data.data();
+        const char* end = at + data.size();
+        size_t applied = 0;
+        while (at < end) {
+            const char* record = at;
+            uint32_t length, checksum;
+            if (!getInt(at, end, length) || !getInt(at, end, checksum) || (uint64_t)(end - at) < length ||
+                crc32(at, length) != checksum) {
+                tornTail = true;
+                at = record;
+                break;
+            }
+            const char* payloadEnd = at + length;
+            uint32_t value;
+            string courseCode, ID;
+            if (length < 1 || (++at, !getString(at, payloadEnd, courseCode)) || !getString(at, payloadEnd, ID) ||
+                !getInt(at, payloadEnd, value)) {
+                tornTail = true;
+                at = record;
+                break;
+            }
+            apply((RecordType)record[8], courseCode, ID, (int)value);
+            applied++;
+            at = payloadEnd;
+        }
+        if (tornTail && truncate(path.c_str(), at - data.data()) != 0) {
+            cout << "Warning: Unable to trim torn log tail!" << endl;
+        }
+        return applied;
+    }
+};
+
+// Hash map with open addressing and Robin Hood linear probing: every entry
+// sits in one flat array, a lookup walks at most a few neighbouring slots and
+// stops early once it passes where the key would have been placed. Erasing
+// shifts the following entries back, so there are no tombstones. Key and
+// Value must be default-constructible. Not thread-safe.
+template <typename Key, typename Value, typename Hasher = hash<Key>>
+class OpenHashMap {
+public:
+    struct Stats {
+        size_t size = 0;
+        size_t capacity = 0;
+        double load_factor = 0;
+        double average_probe = 0;
+        size_t longest_probe = 0;
+    };
+private:
+    struct Slot {
+        Key key;
+        Value value;
+    };
+    vector<Slot> slots;
+    // 0 for an empty slot, otherwise how far the entry is from its home slot plus one.
+    vector<uint32_t> distances;
+    size_t count = 0;
+    size_t mask = 0;
+    int shift = 64;
+    Hasher hasher;
+
+    // std::hash is the identity for integers, so the bits are mixed first.
+    size_t home(const Key& key) const {
+        return (size_t)(((uint64_t)hasher(key) * 0x9E3779B97F4A7C15ULL) >> shift);
+    }
+
+    // Returns the slot holding key, or slots.size() when it is absent.
+    size_t locate(const Key& key) const {
+        if (count == 0) return slots.size();
+        size_t i = home(key);
+        for (uint32_t distance = 1; distances[i] >= distance; distance++) {
+            if (distances[i] == distance && slots[i].key == key) return i;
+            i = (i + 1) & mask;
+        }
+        return slots.size();
+    }
+
+    void place(Slot entry) {
+        size_t i = home(entry.key);
+        uint32_t distance = 1;
+        while (distances[i] != 0) {
+            if (distances[i] < distance) {
+                swap(entry, slots[i]);
+                swap(distance, distances[i]);
+            }
+            i = (i + 1) & mask;
+            distance++;
+        }
+        slots[i] = move(entry);
+        distances[i] = distance;
+        count++;
+    }
+
+    void rehash(size_t capacity) {
+        vector<Slot> old_slots(capacity);
+        vector<uint32_t> old_distances(capacity, 0);
+        old_slots.swap(slots);
+        old_distances.swap(distances);
+        mask = capacity - 1;
+        shift = 64;
+        for (size_t bits = capacity; bits > 1; bits >>= 1) shift--;
+        count = 0;
+        for (size_t i = 0; i < old_slots.size(); i++) {
+            if (old_distances[i] != 0) place(move(old_slots[i]));
+        }
+    }
+
+    void eraseAt(size_t i) {
+        size_t next = (i + 1) & mask;
+        while (distances[next] > 1) {
+            slots[i] = move(slots[next]);
+            distances[i] = distances[next] - 1;
+            i = next;
+            next = (next + 1) & mask;
+        }
+        slots[i] = Slot();
+        distances[i] = 0;
+        count--;
+    }
+public:
+    OpenHashMap() {}
+
+    // Grows so that size entries fit under the 3/4 load limit.
+    void reserve(size_t size) {
+        size_t capacity = 8;
+        while (capacity * 3 < size * 4) capacity <<= 1;
+        if (capacity > slots.size()) rehash(capacity);
+    }
+
+    // Leaves an existing entry alone and returns false.
+    bool insert(const Key& key, const Value& value) {
+        if (locate(key) != slots.size()) return false;
+        reserve(count + 1);
+        place({key, value});
+        return true;
+    }
+
+    void assign(const Key& key, const Value& value) {
+        size_t i = locate(key);
+        if (i != slots.size()) {
+            slots[i].value = value;
+        } else {
+            reserve(count + 1);
+            place({key, value});
+        }
+    }
+
+    Value* find(const Key& key) {
+        size_t i = locate(key);
+        return i == slots.size() ? nullptr : &slots[i].value;
+    }
+
+    const Value* find(const Key& key) const {
+        size_t i = locate(key);
+        return i == slots.size() ? nullptr : &slots[i].value;
+    }
+
+    bool erase(const Key& key) {
+        size_t i = locate(key);
+        if (i == slots.size()) return false;
+        eraseAt(i);
+        return true;
+    }
+
+    // Erases key if it maps to value. Otherwise the value was stored under a
+    // key that has since changed, and only then is the table walked for it.
+    bool eraseEntry(const Key& key, const Value& value) {
+        size_t i = locate(key);
+        if (i != slots.size() && slots[i].value == value) {
+            eraseAt(i);
+            return true;
+        }
+        return eraseValue(value) != 0;
+    }
+
+    // Removes every entry mapped to value by walking the whole table.
+    size_t eraseValue(const Value& value) {
+        size_t erased = 0;
+        for (size_t i = 0; i < slots.size();) {
+            if (distances[i] != 0 && slots[i].value == value) {
+                eraseAt(i);
+                erased++;
+            } else {
+                i++;
+            }
+        }
+        return erased;
+    }
+
+    template <typename Visitor>
+    void forEach(Visitor visit) {
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (distances[i] != 0) visit(slots[i].key, slots[i].value);
+        }
+    }
+
+    void clear() {
+        slots.clear();
+        distances.clear();
+        count = 0;
+        mask = 0;
+        shift = 64;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    Stats stats() const {
+        Stats result;
+        result.size = count;
+        result.capacity = slots.size();
+        if (slots.empty()) return result;
+        result.load_factor = (double)count / slots.size();
+        size_t total = 0;
+        for (uint32_t distance : distances) {
+            total += distance;
+            result.longest_probe = max(result.longest_probe, (size_t)distance);
+        }
+        result.average_probe = count == 0 ? 0 : (double)total / count;
+        return result;
+    }
+};
+
+// Bounded FIFO of students waiting for a seat, kept in a ring buffer. Every
+// entry gets a ticket number, so a student's position is their ticket minus
+// the ticket at the head and needs no scan.
+class WaitlistQueue {
+private:
+    vector<Student*> ring;
+    size_t head = 0, count = 0;
+    uint64_t head_ticket = 0;
+    unordered_map<int, uint64_t> tickets;
+public:
+    WaitlistQueue(size_t capacity = 10) : ring(capacity) {}
+
+    size_t size() {return count;}
+    size_t capacity() {return ring.size();}
+    bool empty() {return count == 0;}
+
+    bool push(Student* student) {
+        if (count == ring.size() || tickets.count(student->getPersonID())) return false;
+        ring[(head + count) % ring.size()] = student;
+        tickets[student->getPersonID()] = head_ticket + count;
+        count++;
+        return true;
+    }
+
+    Student* pop() {
+        if (count == 0) return nullptr;
+        Student* student = ring[head];
+        tickets.erase(student->getPersonID());
+        head = (head + 1) % ring.size();
+        head_ticket++;
+        count--;
+        return student;
+    }
+
+    // Takes a student out of the queue; everyone behind moves up one place.
+    Student* remove(int studentID) {
+        auto it = tickets.find(studentID);
+        if (it == tickets.end()) return nullptr;
+        size_t offset = it->second - head_ticket;
+        Student* student = ring[(head + offset) % ring.size()];
+        tickets.erase(it);
+        for (size_t i = offset; i + 1 < count; i++) {
+            Student* next = ring[(head + i + 1) % ring.size()];
+            ring[(head + i) % ring.size()] = next;
+            tickets[next->getPersonID()]--;
+        }
+        count--;
+        return student;
+    }
+
+    // The i-th waiting student, 0 being the next to be promoted.
+    Student* at(size_t i) {return i < count ? ring[(head + i) % ring.size()] : nullptr;}
+
+    // 1-based place in the queue, 0 when the student is not waiting.
+    int position(int studentID) {
+        auto it = tickets.find(studentID);
+        if (it == tickets.end()) return 0;
+        return it->second - head_ticket + 1;
+    }
+
+    bool resize(size_t capacity) {
+        if (capacity < count || capacity == 0) return false;
+        vector<Student*> resized(capacity);
+        for (size_t i = 0; i < count; i++) {
+            resized[i] = ring[(head + i) % ring.size()];
+        }
+        ring.swap(resized);
+        head = 0;
+        return true;
+    }
+};
+
+class Course{
+                private:
+                    uint32_t code = 0;
+                    string title = "", description = "";
+                    double credits = 0;
+                    Professor* instructor = nullptr;
+                    vector<Student*> enrolled_students;
+                    // Student ID at enrollment -> student, guarded by roster_lock.
+                    OpenHashMap<int, Student*> roster_index;
+                    atomic<int> max_capacity{30};
+                    uint32_t enrollment_deadline = packDate(31, 12, 2023);
+                    bool deadline_full_year = false;
+                    // Guards the roster, its index and the waitlist. Seats are counted
+                    // from the roster under this lock.
+                    mutex roster_lock;
+                    WaitlistQueue waitlist;
+                    function<void(Course&, Student*)> promotion_callback;
+                    WriteAheadLog* wal = nullptr;
+                    friend class UniversitySnapshot;
+                    friend class UniversityRecovery;
+                    friend class BulkImporter;
+
+                    // Must be called with roster_lock held so log order matches roster order.
+                    uint64_t logLocked(WriteAheadLog::RecordType type, Student* student) {
+                        if (wal == nullptr) return 0;
+                        return wal->append(type, symbolText(code), to_string(student->getPersonID()));
+                    }
+
+                    bool isEnrolledLocked(int studentID) {
+                        return roster_index.find(studentID) != nullptr;
+                    }
+
+                    void addToRosterLocked(Student* student) {
+                        enrolled_students.push_back(student);
+                        if (student != nullptr) roster_index.insert(student->getPersonID(), student);
+                    }
+
+                    // Roster position of the student with this ID, or -1. Someone whose ID
+                    // changed after enrolling is not in the index under it and is found by a scan.
+                    int rosterPositionLocked(int studentID) {
+                        Student** indexed = roster_index.find(studentID);
+                        Student* student = indexed != nullptr && (*indexed)->getPersonID() == studentID ? *indexed : nullptr;
+                        for (size_t i = 0; student == nullptr && i < enrolled_students.size(); i++) {
+                            if (enrolled_students[i] != nullptr && enrolled_students[i]->getPersonID() == studentID) student = enrolled_students[i];
+                        }
+                        if (student == nullptr) return -1;
+                        return find(enrolled_students.begin(), enrolled_students.end(), student) - enrolled_students.begin();
+                    }
+
+                    // Erases in place so the roster keeps its enrollment order.
+                    void removeFromRosterLocked(size_t position) {
+                        Student* student = enrolled_students[position];
+                        enrolled_students.erase(enrolled_students.begin() + position);
+                        if (student != nullptr) roster_index.eraseEntry(student->getPersonID(), student);
+                    }
+
+                    // Hands a free seat (checked by the caller) to the head of the waitlist.
+                    // Needs roster_lock.
+                    Student* promoteFromWaitlistLocked(uint64_t& lsn) {
+                        while (!waitlist.empty()) {
+                            Student* next = waitlist.pop();
+                            if (!isEnrolledLocked(next->getPersonID())) {
+                                addToRosterLocked(next);
+                                lsn = logLocked(WriteAheadLog::COURSE_ENROLL, next);
+                                return next;
+                            }
+                            lsn = logLocked(WriteAheadLog::WAITLIST_LEAVE, next);
+                        }
+                        return nullptr;
+                    }
+
+                    void notifyPromotion(Student* student) {
+                        cout << "Student ID: " << student->getPersonID() << " Promoted from Waitlist of " << symbolText(code) << "!\n";
+                        if (promotion_callback) promotion_callback(*this, student);
+                    }
+
+                    bool hasSeatLocked() {
+                        return (int)enrolled_students.size() < max_capacity;
+                    }
+                public:
+                    Course(){}
+                    Course(const string& code, string title, string description, double credits, int max_capacity = 30){
+                        this->code = intern(code);
+                        this->title = move(title);
+                        this->description = move(description);
+                        this->credits = credits;
+                        this->max_capacity = max_capacity;
+                    }
+                
+                    const string& getCourseCode() {return symbolText(code);}
+                    uint32_t getCourseCodeSymbol() {return code;}
+                    const string& getCourseTitle() {return title;}
+                    const string& getCourseDescription() {return description;}
+                    double getCourseCredits() {return credits;}
+                    Professor* getCourseInstructor() {return instructor;}
+                    vector<Student*> getEnrolledStudents() {
+                        lock_guard<mutex> guard(roster_lock);
+                        return enrolled_students;
+                    }
+                    // Roster size without copying the roster.
+                    int getEnrolledCount() {
+                        lock_guard<mutex> guard(roster_lock);
+                        return enrolled_students.size();
+                    }
+                    int getMaxCapacity() {return max_capacity;}
+                    int getWaitlistPosition(int studentID) {
+                        lock_guard<mutex> guard(roster_lock);
+                        return waitlist.position(studentID);
+                    }
+                    int getWaitlistSize() {
+                        lock_guard<mutex> guard(roster_lock);
+                        return waitlist.size();
+                    }
+                    string getEnrollmentDeadline() {return formatDate(enrollment_deadline, deadline_full_year);}
+                    uint32_t getEnrollmentDeadlineDay() {return enrollment_deadline;}
+                
+                    void setCourseCode(const string& code) {
+                        if (!code.empty()) {
+                            this->code = intern(code);
+                            cout << "Course Code Updated Successfully!\n";
+                        } else {
+                            cout << "Course Code Cannot be Empty!\nCode not Updated!\n";
+                            return;
+                        }
+                    }
+                    
+                    void setCourseTitle(string title){
+                        if (!title.empty()) {
+                            this->title = move(title);
+                            cout << "Course Title Updated Successfully!\n";
+                        } else {
+                            cout << "Course Title Cannot be Empty!\nTitle not Updated!\n";
+                            return;
+                        }
+                    }
+                    
+                    void setCourseDescription(string description){
+                        this->description = move(description);
+                        cout << "Course Description Updated Successfully!\n";
+                    }
+                    
+                    void setCourseCredits(double credits){
+                        if (credits > 0){
+                            this->credits = credits;
+                            cout << "Course Credits Updated Successfully!\n";
+                        }
+                        else {
+                            cout << "Credits Must be Positive!\nCourse Credits Not Updated!\n";
+                            return;
+                        }
+                    }
+                    
+                    void setMaxCapacity(int capacity) {
+                        if (capacity > 0) {
+                            vector<Student*> promoted;
+                            uint64_t lsn = 0;
+                            {
+                                lock_guard<mutex> guard(roster_lock);
+                                this->max_capacity = capacity;
+                                while (!waitlist.empty() && hasSeatLocked()) {
+                                    Student* next = promoteFromWaitlistLocked(lsn);
+                                    if (next != nullptr) promoted.push_back(next);
+                                }
+                            }
+                            // The promotions stand even if they could not be logged, so they are
+                            // still announced after the error.
+                            if (lsn != 0 && !wal->tryCommit(lsn)) {
+                                reportError("Capacity Update Error: ", UniversityError(610, 0, capacity, code));
+                            } else {
+                                cout << "Course Maximum Capacity Updated Successfully!\n";
+                            }
+                            for (auto student : promoted) {
+                                notifyPromotion(student);
+                            }
+                        } else {
+                            cout << "Capacity Must be Positive!\nCapacity not Updated!\n";
+                            return;
+                        }
+                    }
+                    
+                    void setEnrollmentDeadline(const string& deadline) {
+                        uint32_t packed = parseDate(deadline);
+                        if (packed != 0) {
+                            this->enrollment_deadline = packed;
+                            this->deadline_full_year = fourDigitYear(deadline);
+                            cout << "Course Enrollment Deadline Updated Successfully!\n";
+                        } else {
+                            cout << "Date Format Invalid!\nEnrollment Deadline not Updated!\n";
+                            return;
+                        }
+                    }
+
+                    // Marks which packed request dates are on or before the deadline and
+                    // returns how many are. Branch-free so the compiler can vectorize it.
+                    size_t checkDeadlines(const uint32_t* dates, size_t count, uint8_t* on_time) const {
+                        const uint32_t deadline = enrollment_deadline;
+                        size_t allowed = 0;
+                        for (size_t i = 0; i < count; i++) {
+                            uint8_t ok = dates[i] != 0 && dates[i] <= deadline;
+                            on_time[i] = ok;
+                            allowed += ok;
+                        }
+                        return allowed;
+                    }
+                    
+                    void setInstructor(Professor* professor) {
+                        this->instructor = professor;
+                        cout << "Course Instructor Set Successfully!\n";
+                    }
+                    
+                    void setWaitlistCapacity(int capacity) {
+                        bool resized = false;
+                        if (capacity > 0) {
+                            lock_guard<mutex> guard(roster_lock);
+                            resized = waitlist.resize(capacity);
+                        }
+                        if (resized) {
+                            cout << "Course Waitlist Capacity Updated Successfully!\n";
+                        } else {
+                            cout << "Waitlist Capacity Must be Positive and Hold Everyone Waiting!\nWaitlist Capacity not Updated!\n";
+                        }
+                    }
+                    
+                    // Enrollments and drops are logged here and made durable before they
+                    // are reported as successful.
+                    void setWriteAheadLog(WriteAheadLog* log) {
+                        this->wal = log;
+                    }
+                    
+                    // Called after a waitlisted student has been moved into the course.
+                    void setPromotionCallback(function<void(Course&, Student*)> callback) {
+                        this->promotion_callback = move(callback);
+                    }
+                    
+                    enum EnrollStatus { ENROLLED, ALREADY_ENROLLED, WAITLISTED };
+                    struct Enrollment {
+                        EnrollStatus status;
+                        int waitlist_position;
+                    };
+
+                    // Safe to call from several threads at once. Prints nothing and
+                    // reports a late, full or invalid request as an error instead of throwing.
+                    // Error 610 means the roster did change but its log record is not durable.
+                    Result<Enrollment> tryEnrollStudent(Student* student, const string& current_date) {
+                        uint32_t today = parseDate(current_date);
+                        if (today == 0) return UniversityError(102, student->getPersonID(), 0, code);
+                        if (today > enrollment_deadline) {
+                            UniversityError error(103, student->getPersonID(), 0, code);
+                            error.deadline = enrollment_deadline;
+                            error.date = today;
+                            error.deadline_full_year = deadline_full_year;
+                            error.date_full_year = fourDigitYear(current_date);
+                            return error;
+                        }
+
+                        Enrollment enrollment = {ENROLLED, 0};
+                        uint64_t lsn = 0;
+                        {
+                            lock_guard<mutex> guard(roster_lock);
+                            if (isEnrolledLocked(student->getPersonID())) {
+                                enrollment.status = ALREADY_ENROLLED;
+                            } else if (hasSeatLocked()) {
+                                addToRosterLocked(student);
+                                lsn = logLocked(WriteAheadLog::COURSE_ENROLL, student);
+                            } else {
+                                // Full: queue the student once instead of turning them away.
+                                bool queued = waitlist.push(student);
+                                if (!queued && waitlist.position(student->getPersonID()) == 0) {
+                                    UniversityError error(101, student->getPersonID(), max_capacity, code);
+                                    error.enrolled = enrolled_students.size();
+                                    return error;
+                                }
+                                if (queued) lsn = logLocked(WriteAheadLog::WAITLIST_JOIN, student);
+                                enrollment.status = WAITLISTED;
+                                enrollment.waitlist_position = waitlist.position(student->getPersonID());
+                            }
+                        }
+                        if (lsn != 0 && !wal->tryCommit(lsn)) return UniversityError(610, student->getPersonID(), 0, code);
+                        return enrollment;
+                    }
+
+                    void enrollStudent(Student* student, const string& current_date) {
+                        Result<Enrollment> result = tryEnrollStudent(student, current_date);
+                        if (!result) {
+                            reportError("Enrollment Error: ", result.error());
+                        } else if (result.value().status == ALREADY_ENROLLED) {
+                            cout << "Student Already Enrolled in this Course!\n";
+                        } else if (result.value().status == WAITLISTED) {
+                            cout << "Course Full! Student Added to Waitlist at Position " << result.value().waitlist_position << "!\n";
+                        } else {
+                            cout << "Student Enrolled in Course Successfully!\n";
+                        }
+                    }
+                    
+                    // Returns the student promoted from the waitlist, or nullptr. A student
+                    // who is only waitlisted leaves the queue and nobody is promoted. Error 610
+                    // means the drop happened but its log record is not durable; a
+                    // promotion it caused is then announced here, since the caller cannot see it.
+                    Result<Student*> tryDropStudent(int studentID) {
+                        unique_lock<mutex> guard(roster_lock);
+                        int position = rosterPositionLocked(studentID);
+                        Student* promoted = nullptr;
+                        uint64_t lsn = 0;
+                        if (position >= 0) {
+                            lsn = logLocked(WriteAheadLog::COURSE_DROP, enrolled_students[position]);
+                            removeFromRosterLocked(position);
+                            // The freed seat only goes to the queue if the capacity still has
+                            // room for it; it may have been lowered below the roster size.
+                            if (!waitlist.empty() && hasSeatLocked()) promoted = promoteFromWaitlistLocked(lsn);
+                        } else if (Student* waiting = waitlist.remove(studentID)) {
+                            lsn = logLocked(WriteAheadLog::WAITLIST_LEAVE, waiting);
+                        } else {
+                            return UniversityError(104, studentID, 0, code);
+                        }
+                        guard.unlock();
+                        if (lsn != 0 && !wal->tryCommit(lsn)) {
+                            if (promoted != nullptr) notifyPromotion(promoted);
+                            return UniversityError(610, studentID, 0, code);
+                        }
+                        return promoted;
+                    }
+
+                    void dropStudent(int studentID) {
+                        Result<Student*> result = tryDropStudent(studentID);
+                        if (!result) {
+                            reportError("Drop Student Error: ", result.error());
+                            return;
+                        }
+                        cout << "Student Dropped from Course Successfully!\n";
+                        if (result.value() != nullptr) notifyPromotion(result.value());
+                    }
+
+                    void reportError(const char* prefix, const UniversityError& error) {
+                        string details = error.getDetails();
+                        cout << prefix << error.message() << endl;
+                        cout << details << endl;
+                        writeToErrorLog(details);
+                    }
+                    
+                    void displayCourseDetails() {
+                        cout << "Course Details:\n";
+                        cout << "Code: " << symbolText(code) << "\n";
+                        cout << "Title: " << title << "\n";
+                        cout << "Description: " << description << "\n";
+                        cout << "Credits: " << credits << "\n";
+                        cout << "Max Capacity: " << max_capacity << "\n";
+                        cout << "Enrollment Deadline: " << formatDate(enrollment_deadline, deadline_full_year) << "\n";
+                        
+                        if (instructor != nullptr) {
+                            cout << "Instructor: " << instructor->getPersonName() << "\n";
+                        } else {
+                            cout << "No Instructor Assigned\n";
+                        }
+                        
+                        cout << "Enrolled Students: " << getEnrolledCount() << "\n";
+                        cout << "Waitlisted Students: " << getWaitlistSize() << "\n";
+                    }
+                
+                    void displayEnrolledStudents() {
+                        lock_guard<mutex> guard(roster_lock);
+                        if (enrolled_students.empty()) {
+                            cout << "No Students Enrolled in this Course!\n";
+                            return;
+                        }
+                        cout << "Students Enrolled in " << title << ":\n";
+                        for (auto student : enrolled_students) {
+                            cout << "ID: " << student->getPersonID() << ", Name: " << student->getPersonName() << "\n";
+                        }
+                    }
+                    
+                    void writeToErrorLog(const string& errorDetails) {
+                        // ctime() shares a static buffer and appends must not interleave.
+                        static mutex log_lock;
+                        lock_guard<mutex> guard(log_lock);
+                        ofstream logFile(errorLogPath(), ios::app);
+                        if (logFile.is_open()) {
+                            time_t now = time(0);
+                            char* dt = ctime(&now);
+                            logFile << "[" << dt << "] " << errorDetails << endl;
+                            logFile.close();
+                        } else {
+                            cout << "Warning: Unable to open error log file!" << endl;
+                        }
+                    }
+                };
+
+class Department{
+private:
+    uint32_t name = 0;
+    string location = "";
+    double budget;
+    vector<Professor*> professors;
+    // Professor ID when added -> professor.
+    OpenHashMap<int, Professor*> professor_index;
+    friend class UniversitySnapshot;
+
+    void insertProfessor(Professor* professor) {
+        professors.push_back(professor);
+        if (professor != nullptr) professor_index.insert(professor->getPersonID(), professor);
+    }
+public:
+    Department(){}
+    Department(const string& name, string location, double budget){
+        this->name = intern(name);
+        this->location = move(location);
+        this->budget = budget;
+    }
+
+    const string& getDepartmentName() {return symbolText(name);}
+    uint32_t getDepartmentNameSymbol() {return name;}
+    const string& getDepartmentLocation() {return location;}
+    double getDepartmentBudget() {return budget;}
+    const vector<Professor*>& getDepartmentProfessors() {return professors;}
+    OpenHashMap<int, Professor*>::Stats getProfessorIndexStats() {return professor_index.stats();}
+
+    void setDepartmentName(const string& name) {
+        this->name = intern(name);
+        cout << "Department Name Updated Successfully!\n";
+    }
+    void setDepartmentLocation(string location){
+        this->location = move(location);
+        cout << "Department Location Updated Successfully!\n";
+    } 
+    void setDepartmentBudget(double budget){
+        if (budget>0) {
+            this->budget = budget;
+            cout << "Department Budget Updated Successfully!\n";
+        }
+        else {
+            cout << "Budget Should be greater then 0!\n Budget not Updated!"; return;
+        }
+    }
+    void addProfessor(Professor* professor) {
+        insertProfessor(professor);
+        cout << "Professor Added to Department Successfully!\n";
+    }
+
+    // Someone whose ID changed after being added is found by a scan instead.
+    Professor* findProfessor(int professorID) {
+        Professor** indexed = professor_index.find(professorID);
+        if (indexed != nullptr && (*indexed)->getPersonID() == professorID) return *indexed;
+        for (auto professor : professors) {
+            if (professor != nullptr && professor->getPersonID() == professorID) return professor;
+        }
+        return nullptr;
+    }
+
+    void removeProfessor(int professorID) {
+        Professor* professor = findProfessor(professorID);
+        if (professor != nullptr) {
+            professors.erase(find(professors.begin(), professors.end(), professor));
+            professor_index.eraseEntry(professorID, professor);
+            cout << "Professor Removed from Department Successfully!\n";
+            return;
+        }
+        cout << "Professor Not Found in Department!\n";
+    }
+
+    void displayProfessors() {
+        if (professors.empty()) {
+            cout << "No Professors in this Department!\n";
+            return;
+        }
+        cout << "Professors in Department " << symbolText(name) << ":\n";
+        for (auto prof : professors) {
+            prof->displayDetails();
+            cout << "------------------------\n";
+        }
+    }
+};
+
+
+
+struct GradeStats {
+    size_t count = 0;
+    long long sum = 0;
+    long long sumOfSquares = 0;
+    int lowest = 0;
+    int highest = 0;
+    double mean = 0;
+    double stddev = 0;
+};
+
+// Kernels over contiguous uint8_t grade columns. Each has an AVX2 version that
+// is picked at run time when the CPU supports it, and a plain loop otherwise.
+class GradeAnalytics {
+private:
+#ifdef UNIVERSITY_HAVE_AVX2
+    static bool hasAVX2() {
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+    }
+
+    __attribute__((target("avx2")))
+    static void sumsAVX2(const uint8_t* grades, size_t n, long long& sum, long long& sumOfSquares) {
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i sums = zero, squares64 = zero;
+        size_t i = 0;
+        while (i + 32 <= n) {
+            // 32-bit square accumulators are flushed before they can overflow.
+            __m256i squares32 = zero;
+            size_t block_end = min(n - (n - i) % 32, i + 32 * 8192);
+            for (; i < block_end; i += 32) {
+                __m256i v = _mm256_loadu_si256((const __m256i*)(grades + i));
+                sums = _mm256_add_epi64(sums, _mm256_sad_epu8(v, zero));
+                __m256i lo = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v));
+                __m256i hi = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1));
+                squares32 = _mm256_add_epi32(squares32, _mm256_madd_epi16(lo, lo));
+                squares32 = _mm256_add_epi32(squares32, _mm256_madd_epi16(hi, hi));
+            }
+            squares64 = _mm256_add_epi64(squares64, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(squares32)));
+            squares64 = _mm256_add_epi64(squares64, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(squares32, 1)));
+        }
+        long long lanes[4];
+        _mm256_storeu_si256((__m256i*)lanes, sums);
+        sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        _mm256_storeu_si256((__m256i*)lanes, squares64);
+        sumOfSquares = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        for (; i < n; i++) {
+            sum += grades[i];
+            sumOfSquares += grades[i] * grades[i];
+        }
+    }
+
+    __attribute__((target("avx2")))
+    static void minMaxAVX2(const uint8_t* grades, size_t n, int& lowest, int& highest) {
+        __m256i lo = _mm256_set1_epi8((char)0xFF), hi = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(grades + i));
+            lo = _mm256_min_epu8(lo, v);
+            hi = _mm256_max_epu8(hi, v);
+        }
+        uint8_t lo_lanes[32], hi_lanes[32];
+        _mm256_storeu_si256((__m256i*)lo_lanes, lo);
+        _mm256_storeu_si256((__m256i*)hi_lanes, hi);
+        lowest = 255; highest = 0;
+        for (int k = 0; k < 32; k++) {
+            lowest = min(lowest, (int)lo_lanes[k]);
+            highest = max(highest, (int)hi_lanes[k]);
+        }
+        for (; i < n; i++) {
+            lowest = min(lowest, (int)grades[i]);
+            highest = max(highest, (int)grades[i]);
+        }
+    }
+
+    __attribute__((target("avx2")))
+    static void belowAVX2(const uint8_t* grades, size_t n, int limit, vector<uint32_t>& indices) {
+        // Grades never exceed 100, so a signed byte compare is safe.
+        const __m256i bound = _mm256_set1_epi8((char)limit);
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(grades + i));
+            uint32_t mask = _mm256_movemask_epi8(_mm256_cmpgt_epi8(bound, v));
+            while (mask != 0) {
+                indices.push_back(i + __builtin_ctz(mask));
+                mask &= mask - 1;
+            }
+        }
+        for (; i < n; i++) {
+            if (grades[i] < limit) indices.push_back(i);
+        }
+    }
+#endif
+public:
+    static void sums(const uint8_t* grades, size_t n, long long& sum, long long& sumOfSquares) {
+#ifdef UNIVERSITY_HAVE_AVX2
+        if (hasAVX2()) {
+            sumsAVX2(grades, n, sum, sumOfSquares);
+            return;
+        }
+#endif
+        sum = 0; sumOfSquares = 0;
+        for (size_t i = 0; i < n; i++) {
+            sum += grades[i];
+            sumOfSquares += grades[i] * grades[i];
+        }
+    }
+
+    static void minMax(const uint8_t* grades, size_t n, int& lowest, int& highest) {
+        if (n == 0) {
+            lowest = highest = 0;
+            return;
+        }
+#ifdef UNIVERSITY_HAVE_AVX2
+        if (hasAVX2()) {
+            minMaxAVX2(grades, n, lowest, highest);
+            return;
+        }
+#endif
+        lowest = 255; highest = 0;
+        for (size_t i = 0; i < n; i++) {
+            lowest = min(lowest, (int)grades[i]);
+            highest = max(highest, (int)grades[i]);
+        }
+    }
+
+    // Indices of every grade strictly below passMarks, in ascending order.
+    static vector<uint32_t> failingIndices(const uint8_t* grades, size_t n, double passMarks = 33.5) {
+        vector<uint32_t> indices;
+        int limit = (int)min(max(ceil(passMarks), 0.0), 101.0);
+#ifdef UNIVERSITY_HAVE_AVX2
+        if (hasAVX2()) {
+            belowAVX2(grades, n, limit, indices);
+            return indices;
+        }
+#endif
+        for (size_t i = 0; i < n; i++) {
+            if (grades[i] < limit) indices.push_back(i);
+        }
+        return indices;
+    }
+
+    static GradeStats summarize(const uint8_t* grades, size_t n) {
+        GradeStats stats;
+        stats.count = n;
+        if (n == 0) return stats;
+        sums(grades, n, stats.sum, stats.sumOfSquares);
+        minMax(grades, n, stats.lowest, stats.highest);
+        finish(stats);
+        return stats;
+    }
+
+    // Fills in mean and standard deviation from count, sum and sumOfSquares.
+    static void finish(GradeStats& stats) {
+        if (stats.count == 0) return;
+        stats.mean = (double)stats.sum / stats.count;
+        double variance = (double)stats.sumOfSquares / stats.count - stats.mean * stats.mean;
+        stats.stddev = sqrt(max(variance, 0.0));
+    }
+
+    static GradeStats combine(const vector<GradeStats>& parts) {
+        GradeStats total;
+        bool first = true;
+        for (const GradeStats& part : parts) {
+            if (part.count == 0) continue;
+            total.lowest = first ? part.lowest : min(total.lowest, part.lowest);
+            total.highest = first ? part.highest : max(total.highest, part.highest);
+            total.count += part.count;
+            total.sum += part.sum;
+            total.sumOfSquares += part.sumOfSquares;
+            first = false;
+        }
+        finish(total);
+        return total;
+    }
+};
+
+class GradeBook{
+private:
+    static constexpr int MAX_GRADE = 100;
+
+    // Grades live in a column indexed by a dense per-student slot. The sum, the
+    // highest mark and the order index below are updated on every addGrade, so
+    // the aggregate queries never need to look at individual grades.
+    unordered_map<string, uint32_t> studentSlots;
+    vector<string> studentIDs;
+    vector<uint8_t> grades;
+    long long gradeSum = 0;
+    int highest = 0;
+    string courseCode = "";
+
+    // Counting-sort order index: the slots holding each grade, and a Fenwick
+    // tree over the bucket sizes for rank and percentile lookups.
+    vector<uint32_t> gradeBuckets[MAX_GRADE + 1];
+    vector<uint32_t> bucketPositions;
+    int fenwick[MAX_GRADE + 2] = {};
+
+    void fenwickAdd(int grade, int delta){
+        for (int i = grade + 1; i <= MAX_GRADE + 1; i += i & -i) fenwick[i] += delta;
+    }
+
+    void bucketInsert(uint32_t slot, int grade){
+        bucketPositions[slot] = gradeBuckets[grade].size();
+        gradeBuckets[grade].push_back(slot);
+        fenwickAdd(grade, 1);
+    }
+
+    void bucketRemove(uint32_t slot, int grade){
+        vector<uint32_t>& bucket = gradeBuckets[grade];
+        uint32_t moved = bucket.back();
+        bucket[bucketPositions[slot]] = moved;
+        bucketPositions[moved] = bucketPositions[slot];
+        bucket.pop_back();
+        fenwickAdd(grade, -1);
+    }
+
+    // Number of grades <= grade.
+    int countAtMost(int grade){
+        if (grade < 0) return 0;
+        int count = 0;
+        for (int i = min(grade, MAX_GRADE) + 1; i > 0; i -= i & -i) count += fenwick[i];
+        return count;
+    }
+
+    // The k-th smallest grade, 1-based.
+    int gradeAtRank(int k){
+        int position = 0;
+        for (int step = 64; step > 0; step >>= 1){
+            if (position + step <= MAX_GRADE + 1 && fenwick[position + step] < k){
+                position += step;
+                k -= fenwick[position];
+            }
+        }
+        return position;
+    }
+
+    void storeGrade(const string& ID, int Grade){
+        auto slot = studentSlots.emplace(ID, grades.size());
+        uint32_t index = slot.first->second;
+        if (slot.second){
+            studentIDs.push_back(ID);
+            grades.push_back(Grade);
+            bucketPositions.push_back(0);
+        } else {
+            int old = grades[index];
+            grades[index] = Grade;
+            gradeSum -= old;
+            bucketRemove(index, old);
+        }
+        gradeSum += Grade;
+        bucketInsert(index, Grade);
+        highest = gradeAtRank(grades.size());
+    }
+
+    WriteAheadLog* wal = nullptr;
+
+    friend class UniversitySnapshot;
+    friend class UniversityRecovery;
+    friend class BulkImporter;
+public:
+    GradeBook(){}
+    GradeBook(string courseCode){
+        this->courseCode = move(courseCode);
+    }
+
+    const string& getCourseCode(){
+        return courseCode;
+    }
+
+    // Grades are logged under this book's course code, so give it one first.
+    void setWriteAheadLog(WriteAheadLog* log){
+        this->wal = log;
+    }
+
+    // A grade whose log record cannot be made durable stays changed and is
+    // reported as error 610, like an unlogged enrollment.
+    void addGrade(const string& ID, int Grade){
+        if (Grade <= 100 && Grade >= 0){
+            storeGrade(ID, Grade);
+            if (wal != nullptr && !wal->tryCommit(wal->append(WriteAheadLog::GRADE, courseCode, ID, Grade))){
+                // Looked up, not interned, so reporting an error adds no symbol.
+                uint32_t course;
+                if (!symbols().lookup(courseCode, course)) course = 0;
+                UniversityError error(610, atoi(ID.c_str()), Grade, course);
+                cout << "Grade Error: " << error.message() << endl;
+                cout << error.getDetails() << endl;
+                return;
+            }
+            cout << "Grade of Student ID: " << ID << " Updated Successfully!\n";
+        } else {
+            cout << "Invalid Grades!\n Student Grade Not Updated!\n";
+            return;
+        }
+    }
+
+    int getGradeCount(){
+        return grades.size();
+    }
+
+    const vector<uint8_t>& getGradeColumn(){
+        return grades;
+    }
+
+    const vector<string>& getStudentIDColumn(){
+        return studentIDs;
+    }
+
+    GradeStats getStatistics(){
+        return GradeAnalytics::summarize(grades.data(), grades.size());
+    }
+
+    double averageGrade(){
+        if (grades.empty()){ return 0;}
+        return (double)gradeSum/grades.size();
+    }
+
+    int HighestMarks(){
+        return highest;
+    }
+
+    int getFailCount(double PassMarks = 33.5){
+        return countAtMost((int)ceil(PassMarks) - 1);
+    }
+
+    // Nearest-rank percentile, e.g. getPercentile(90) is the grade that 90% of
+    // the class is at or below.
+    int getPercentile(double percent){
+        if (grades.empty()) return 0;
+        percent = min(max(percent, 0.0), 100.0);
+        // Divide last: percent / 100 first rounds 7 / 100 * 100 up to a hair over 7.
+        long long rank = max(1LL, (long long)ceil(percent * grades.size() / 100));
+        return gradeAtRank(rank);
+    }
+
+    double getMedian(){
+        if (grades.empty()) return 0;
+        int n = grades.size();
+        if (n % 2 == 1) return gradeAtRank((n + 1) / 2);
+        return (gradeAtRank(n / 2) + gradeAtRank(n / 2 + 1)) / 2.0;
+    }
+
+    // 1 for the top grade; students with equal grades share a rank. 0 if the
+    // student has no grade.
+    int getStudentRank(const string& ID){
+        auto slot = studentSlots.find(ID);
+        if (slot == studentSlots.end()) return 0;
+        return grades.size() - countAtMost(grades[slot->second]) + 1;
+    }
+
+    // Best k students as (ID, grade), highest grade first.
+    vector<pair<string, int>> getTopStudents(int k){
+        vector<pair<string, int>> results;
+        for (int g = highest; g >= 0 && (int)results.size() < k; g--){
+            for (uint32_t index : gradeBuckets[g]){
+                if ((int)results.size() == k) break;
+                results.push_back({studentIDs[index], g});
+            }
+        }
+        return results;
+    }
+
+    // Sorted by student ID, the order the old map-based book returned them in.
+    vector<string> failingStudents(double PassMarks = 33.5){
+        if (getFailCount(PassMarks) == 0) return {};
+        vector<string> results;
+
+        for (uint32_t i : GradeAnalytics::failingIndices(grades.data(), grades.size(), PassMarks)){
+            results.push_back(studentIDs[i]);
+        }
+        sort(results.begin(), results.end());
+
+        return results;
+    }
+
+    void showGrades(){
+        if (grades.empty()){
+            cout << "Empty Grades!\n";
+            return;
+        }
+
+        // Listed by student ID, as before the grades went into columns.
+        vector<uint32_t> order(grades.size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = i;
+        sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b){ return studentIDs[a] < studentIDs[b]; });
+
+        cout << "Student ID\tGrades\n";
+        for (uint32_t i : order){
+            cout << studentIDs[i] << '\t' << (int)grades[i] << '\n';
+        }
+    }
+};
+
+// Statistics for many courses in one pass, with the gradebooks spread over a
+// few worker threads.
+class CohortAnalytics {
+public:
+    static vector<GradeStats> summarize(const vector<GradeBook*>& books, unsigned threads = 0){
+        vector<GradeStats> results(books.size());
+        if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+        threads = min<unsigned>(threads, max<size_t>(books.size(), 1));
+
+        atomic<size_t> next{0};
+        auto work = [&](){
+            for (size_t i = next++; i < books.size(); i = next++){
+                results[i] = books[i]->getStatistics();
+            }
+        };
+        vector<thread> workers;
+        for (unsigned t = 1; t < threads; t++){
+            workers.emplace_back(work);
+        }
+        work();
+        for (auto& worker : workers){
+            worker.join();
+        }
+        return results;
+    }
+
+    static vector<vector<string>> failingStudents(const vector<GradeBook*>& books, double PassMarks = 33.5){
+        vector<vector<string>> results;
+        results.reserve(books.size());
+        for (auto book : books){
+            results.push_back(book->failingStudents(PassMarks));
+        }
+        return results;
+    }
+};
+
+class EnrollmentManager{
+private:
+    static const uint32_t SHARD_COUNT = 16;
+
+    static const uint32_t DROPPED = UINT32_MAX;
+
+    // Every enrollment takes the next order number. Rosters and each student's
+    // course list stay sorted by it, so both list in enrollment order and an
+    // undone drop goes back where it was.
+    struct Entry {
+        uint64_t order;
+        uint32_t id;
+    };
+
+    // A drop leaves a DROPPED entry behind, found through slots in O(1). The
+    // entries are squeezed once tombstones outnumber the live ones.
+    struct Roster {
+        vector<Entry> entries;
+        // Student id -> index in entries.
+        unordered_map<uint32_t, uint32_t> slots;
+
+        void insert(uint32_t student, uint64_t order) {
+            if (entries.empty() || entries.back().order < order) {
+                slots[student] = entries.size();
+                entries.push_back({order, student});
+                return;
+            }
+            // An undone drop: revive its tombstone, or reopen its place if squeezed out.
+            auto at = lower_bound(entries.begin(), entries.end(), order, [](const Entry& entry, uint64_t key) { return entry.order < key; });
+            if (at != entries.end() && at->order == order) {
+                at->id = student;
+                slots[student] = at - entries.begin();
+                return;
+            }
+            size_t slot = entries.insert(at, {order, student}) - entries.begin();
+            renumber(slot);
+        }
+
+        // Returns the order the student had.
+        uint64_t erase(uint32_t slot) {
+            Entry& entry = entries[slot];
+            slots.erase(entry.id);
+            entry.id = DROPPED;
+            uint64_t order = entry.order;
+            if (entries.size() > 2 * slots.size() + 16) {
+                entries.erase(remove_if(entries.begin(), entries.end(), [](const Entry& entry) { return entry.id == DROPPED; }), entries.end());
+                renumber(0);
+            }
+            return order;
+        }
+
+        void renumber(size_t from) {
+            for (size_t i = from; i < entries.size(); i++) {
+                if (entries[i].id != DROPPED) slots[entries[i].id] = i;
+            }
+        }
+    };
+
+    // Rosters are split by course id and the reverse index by student id, each
+    // shard behind its own mutex. Writers always take the course shard first.
+    struct CourseShard {
+        mutex lock;
+        unordered_map<uint32_t, Roster> rosters;
+    };
+    // A student's courses are few, so they stay a sorted vector.
+    struct StudentShard {
+        mutex lock;
+        unordered_map<uint32_t, vector<Entry>> courses;
+    };
+
+    // Course ids are the shared symbols (see symbols()), so they match Course codes.
+    StringInterner studentIDs;
+    CourseShard courseShards[SHARD_COUNT];
+    StudentShard studentShards[SHARD_COUNT];
+
+    CourseShard& courseShard(uint32_t course) {return courseShards[course % SHARD_COUNT];}
+    StudentShard& studentShard(uint32_t student) {return studentShards[student % SHARD_COUNT];}
+
+
+    WriteAheadLog* wal = nullptr;
+
+    atomic<uint64_t> next_order{1};
+
+    // Both log while the course shard is still locked, so log order matches the
+    // order rosters changed in. lsn is 0 when nothing was logged. order 0 means
+    // a new enrollment; an undone drop passes the order removeEnrollment gave.
+    bool insertEnrollment(const string& courseCode, const string& ID, uint64_t& lsn, bool log = true, uint64_t order = 0){
+        lsn = 0;
+        uint32_t course = symbols().intern(courseCode);
+        uint32_t student = studentIDs.intern(ID);
+        CourseShard& shard = courseShard(course);
+        lock_guard<mutex> guard(shard.lock);
+        Roster& roster = shard.rosters[course];
+        if (roster.slots.count(student) != 0) return false;
+        // Taken under the course shard lock, so each roster's orders only grow.
+        if (order == 0) order = next_order.fetch_add(1, memory_order_relaxed);
+        roster.insert(student, order);
+        StudentShard& reverse = studentShard(student);
+        lock_guard<mutex> reverseGuard(reverse.lock);
+        auto& courses = reverse.courses[student];
+        courses.insert(upper_bound(courses.begin(), courses.end(), order, [](uint64_t key, const Entry& entry) { return key < entry.order; }), {order, course});
+        if (wal != nullptr && log) lsn = wal->append(WriteAheadLog::MANAGER_ENROLL, courseCode, ID);
+        return true;
+    }
+
+    enum RemoveResult { REMOVED, COURSE_NOT_FOUND, NOT_ENROLLED };
+
+    RemoveResult removeEnrollment(const string& courseCode, const string& ID, uint64_t& lsn, bool log = true, uint64_t* order = nullptr){
+        lsn = 0;
+        uint32_t course, student;
+        if (!symbols().lookup(courseCode, course)) return COURSE_NOT_FOUND;
+        CourseShard& shard = courseShard(course);
+        lock_guard<mutex> guard(shard.lock);
+        auto roster = shard.rosters.find(course);
+        if (roster == shard.rosters.end()) return COURSE_NOT_FOUND;
+        if (!studentIDs.lookup(ID, student)) return NOT_ENROLLED;
+        auto slot = roster->second.slots.find(student);
+        if (slot == roster->second.slots.end()) return NOT_ENROLLED;
+        uint64_t dropped = roster->second.erase(slot->second);
+        if (order != nullptr) *order = dropped;
+
+        StudentShard& reverse = studentShard(student);
+        lock_guard<mutex> reverseGuard(reverse.lock);
+        auto& courses = reverse.courses[student];
+        courses.erase(find_if(courses.begin(), courses.end(), [course](const Entry& entry) { return entry.id == course; }));
+        if (wal != nullptr && log) lsn = wal->append(WriteAheadLog::MANAGER_DROP, courseCode, ID);
+        return REMOVED;
+    }
+
+    friend class UniversitySnapshot;
+    friend class UniversityRecovery;
+public:
+    EnrollmentManager(){}
+
+    void setWriteAheadLog(WriteAheadLog* log){
+        this->wal = log;
+    }
+
+    void enrollStudent(const string& courseCode, const string& ID){
+        uint64_t lsn;
+        if (!insertEnrollment(courseCode, ID, lsn)){
+            cout << "Student Already Enrolled!\n";
+            return;
+        }
+        if (lsn != 0 && !wal->tryCommit(lsn)){
+            // Undo the change the log could not record, then fail as before.
+            uint64_t unlogged;
+            removeEnrollment(courseCode, ID, unlogged, false);
+            wal->commit(lsn);
+        }
+        cout << "Student of Student ID: " << ID << " enrolled in courseCode: " << courseCode << " succesfully!\n";
+    }
+
+    void dropStudent(const string& courseCode, const string& ID){
+        uint64_t lsn, order;
+        RemoveResult result = removeEnrollment(courseCode, ID, lsn, true, &order);
+        if (result == COURSE_NOT_FOUND){
+            cout << "Course Not Found!\n";
+            return;
+        }
+        if (result == NOT_ENROLLED){
+            cout << "Student Already Not Enrolled!\n";
+            return;
+        }
+        if (lsn != 0 && !wal->tryCommit(lsn)){
+            uint64_t unlogged;
+            insertEnrollment(courseCode, ID, unlogged, false, order);
+            wal->commit(lsn);
+        }
+        cout << "Student Removed Successfully!\n";
+    }
+
+    int getEnrollmentCount(const string& courseCode){
+        uint32_t course;
+        if (!symbols().lookup(courseCode, course)) return 0;
+        CourseShard& shard = courseShard(course);
+        lock_guard<mutex> guard(shard.lock);
+        auto roster = shard.rosters.find(course);
+        if (roster == shard.rosters.end()) return 0;
+        return roster->second.slots.size();
+    }
+
+    vector<string> getEnrolledStudents(const string& courseCode){
+        uint32_t course;
+        if (!symbols().lookup(courseCode, course)) return {};
+        vector<string> result;
+        CourseShard& shard = courseShard(course);
+        lock_guard<mutex> guard(shard.lock);
+        auto roster = shard.rosters.find(course);
+        if (roster == shard.rosters.end()) return {};
+        result.reserve(roster->second.slots.size());
+        for (const Entry& entry : roster->second.entries){
+            if (entry.id != DROPPED) result.push_back(studentIDs.name(entry.id));
+        }
+        return result;
+    }
+
+    int getStudentCourseCount(const string& ID){
+        uint32_t student;
+        if (!studentIDs.lookup(ID, student)) return 0;
+        StudentShard& shard = studentShard(student);
+        lock_guard<mutex> guard(shard.lock);
+        auto courses = shard.courses.find(student);
+        if (courses == shard.courses.end()) return 0;
+        return courses->second.size();
+    }
+
+    // Calls visit(courseCode) for every course the student is in, without copying
+    // the list. The student's shard stays locked meanwhile, so visit must not call
+    // back into this manager.
+    template <typename Visitor>
+    void forEachStudentCourse(const string& ID, Visitor visit){
+        uint32_t student;
+        if (!studentIDs.lookup(ID, student)) return;
+        StudentShard& shard = studentShard(student);
+        lock_guard<mutex> guard(shard.lock);
+        auto courses = shard.courses.find(student);
+        if (courses == shard.courses.end()) return;
+        for (const Entry& entry : courses->second){
+            visit(symbols().name(entry.id));
+        }
+    }
+
+    // Calls visit(courseCode, studentID) for every enrollment, one shard at a time.
+    template <typename Visitor>
+    void forEachEnrollment(Visitor visit){
+        for (auto& shard : courseShards){
+            lock_guard<mutex> guard(shard.lock);
+            for (auto& roster : shard.rosters){
+                for (const Entry& entry : roster.second.entries){
+                    if (entry.id != DROPPED) visit(symbols().name(roster.first), studentIDs.name(entry.id));
+                }
+            }
+        }
+    }
+
+    vector<string> getStudentCourses(const string& ID){
+        vector<string> result;
+        forEachStudentCourse(ID, [&result](const string& courseCode){
+            result.push_back(courseCode);
+        });
+        return result;
+    }
+
+};
+
+
+class University {
+private:
+    string name = "";
+    string location = "";
+    vector<Department*> departments;
+    // Department name symbol when added -> department.
+    OpenHashMap<uint32_t, Department*> department_index;
+    friend class UniversitySnapshot;
+
+    void insertDepartment(Department* department) {
+        departments.push_back(department);
+        if (department != nullptr) department_index.insert(department->getDepartmentNameSymbol(), department);
+    }
+public:
+    University() {}
+    University(string name, string location) {
+        this->name = move(name);
+        this->location = move(location);
+    }
+    
+    const string& getUniversityName() { return name; }
+    const string& getUniversityLocation() { return location; }
+    const vector<Department*>& getUniversityDepartments() { return departments; }
+    OpenHashMap<uint32_t, Department*>::Stats getDepartmentIndexStats() { return department_index.stats(); }
+    
+    void setUniversityName(string name) {
+        if (!name.empty()) {
+            this->name = move(name);
+            cout << "University Name Updated Successfully!\n";
+        } else {
+            cout << "University Name Cannot be Empty!\nName not Updated!\n";
+        }
+    }
+    
+    void setUniversityLocation(string location) {
+        if (!location.empty()) {
+            this->location = move(location);
+            cout << "University Location Updated Successfully!\n";
+        } else {
+            cout << "University Location Cannot be Empty!\nLocation not Updated!\n";
+        }
+    }
+    
+    void addDepartment(Department* department) {
+        insertDepartment(department);
+        cout << "Department Added to University Successfully!\n";
+    }
+    
+    // A department renamed after being added is found by a scan instead.
+    Department* findDepartment(const string& departmentName) {
+        // A name that was never interned cannot belong to any department.
+        uint32_t symbol;
+        if (!symbols().lookup(departmentName, symbol)) return nullptr;
+        Department** indexed = department_index.find(symbol);
+        if (indexed != nullptr && (*indexed)->getDepartmentNameSymbol() == symbol) return *indexed;
+        for (auto department : departments) {
+            if (department != nullptr && department->getDepartmentNameSymbol() == symbol) return department;
+        }
+        return nullptr;
+    }
+    
+    void removeDepartment(const string& departmentName) {
+        Department* department = findDepartment(departmentName);
+        if (department != nullptr) {
+            departments.erase(find(departments.begin(), departments.end(), department));
+            department_index.eraseEntry(department->getDepartmentNameSymbol(), department);
+            cout << "Department Removed from University Successfully!\n";
+            return;
+        }
+        cout << "Department Not Found in University!\n";
+    }
+    
+    vector<Professor*> getAllProfessors() {
+        vector<Professor*> allProfessors;
+        for (auto dept : departments) {
+            const vector<Professor*>& deptProfessors = dept->getDepartmentProfessors();
+            allProfessors.insert(allProfessors.end(), deptProfessors.begin(), deptProfessors.end());
+        }
+        return allProfessors;
+    }
+    
+    void displayDepartments() {
+        if (departments.empty()) {
+            cout << "No Departments in University!\n";
+            return;
+        }
+        cout << "Departments in " << name << ":\n";
+        for (auto dept : departments) {
+            cout << "Name: " << dept->getDepartmentName() << ", Location: " << dept->getDepartmentLocation() << "\n";
+        }
+    }
+    
+    void displayAllProfessors() {
+        vector<Professor*> allProfessors = getAllProfessors();
+        if (allProfessors.empty()) {
+            cout << "No Professors in University!\n";
+            return;
+        }
+        cout << "All Professors in " << name << ":\n";
+        for (auto prof : allProfessors) {
+            cout << "ID: " << prof->getPersonID() << ", Name: " << prof->getPersonName() << ", Department: " << prof->getProfessorDepartment() << "\n";
+        }
+    }
+};
+
+class Classroom {
+private:
+    string room_number = "";
+    string building = "";
+    int capacity = 0;
+    bool has_projector = false;
+public:
+    Classroom() {}
+    Classroom(string room_number, string building, int capacity, bool has_projector) {
+        this->room_number = move(room_number);
+        this->building = move(building);
+        this->capacity = capacity;
+        this->has_projector = has_projector;
     }
     
-    vector<Professor*> getAllProfessors() {
-        vector<Professor*> allProfessors;
-        for (auto dept : departments) {
-            vector<Professor*> deptProfessors = dept->getDepartmentProfessors();
-            allProfessors.insert(allProfessors.end(), deptProfessors.begin(), deptProfessors.end());
+    const string& getClassroomRoomNumber() { return room_number; }
+    const string& getClassroomBuilding() { return building; }
+    int getClassroomCapacity() { return capacity; }
+    bool getClassroomHasProjector() { return has_projector; }
+    
+    void setClassroomRoomNumber(string room_number) {
+        if (!room_number.empty()) {
+            this->room_number = move(room_number);
+            cout << "Classroom Room Number Updated Successfully!\n";
+        } else {
+            cout << "Room Number Cannot be Empty!\nRoom Number not Updated!\n";
+        }
+    }
+    
+    void setClassroomBuilding(string building) {
+        if (!building.empty()) {
+            this->building = move(building);
+            cout << "Classroom Building Updated Successfully!\n";
+        } else {
+            cout << "Building Cannot be Empty!\nBuilding not Updated!\n";
+        }
+    }
+    
+    void setClassroomCapacity(int capacity) {
+        if (capacity > 0) {
+            this->capacity = capacity;
+            cout << "Classroom Capacity Updated Successfully!\n";
+        } else {
+            cout << "Capacity Must be Positive!\nCapacity not Updated!\n";
+        }
+    }
+    
+    void setClassroomHasProjector(bool has_projector) {
+        this->has_projector = has_projector;
+        cout << "Classroom Projector Status Updated Successfully!\n";
+    }
+
+    void displayClassroomDetails() {
+        cout << "Classroom Details:\n";
+        cout << "Room Number: " << room_number << "\n";
+        cout << "Building: " << building << "\n";
+        cout << "Capacity: " << capacity << "\n";
+        cout << "Has Projector: " << (has_projector ? "Yes" : "No") << "\n";
+    }
+};
+
+class Schedule {
+public:
+    // Days are 0 (Monday) to 6; times are minutes since midnight and a slot
+    // covers [start_minute, end_minute).
+    struct TimeSlot {
+        int day;
+        int start_minute;
+        int end_minute;
+        Course* course;
+        Classroom* classroom;
+    };
+    static const int DAYS = 7, MINUTES_PER_DAY = 24 * 60;
+private:
+    static const int WORDS_PER_DAY = (MINUTES_PER_DAY + 63) / 64;
+
+    // One bit per minute for every (classroom, day) that has a slot, so a
+    // conflict check touches at most a few words instead of every slot.
+    struct RoomWeek {
+        uint64_t minutes[DAYS][WORDS_PER_DAY] = {};
+    };
+
+    // Slots live in a slab whose entries never move; freed entries are reused.
+    // The course and classroom indexes hold slab handles in insertion order,
+    // and each entry remembers where it sits in both. Live entries are also
+    // linked in insertion order, since a reused entry's place in the slab says
+    // nothing about when it was added.
+    struct SlabEntry {
+        TimeSlot slot;
+        uint32_t course_position;
+        uint32_t classroom_position;
+        uint32_t previous, next;
+    };
+    static const uint32_t NO_HANDLE = UINT32_MAX;
+    vector<SlabEntry> slab;
+    vector<uint32_t> free_handles;
+    uint32_t first_handle = NO_HANDLE, last_handle = NO_HANDLE;
+    size_t slot_count = 0;
+    unordered_map<Course*, vector<uint32_t>> by_course;
+    unordered_map<Classroom*, vector<uint32_t>> by_classroom;
+    unordered_map<Classroom*, RoomWeek> occupied;
+    friend class UniversitySnapshot;
+    friend class TimetableSolver;
+
+    // Calls visit(word, mask) for each word the interval covers.
+    template <typename Visitor>
+    static bool forEachWord(int start_minute, int end_minute, Visitor visit) {
+        int first = start_minute / 64, last = (end_minute - 1) / 64;
+        for (int word = first; word <= last; word++) {
+            int low = word == first ? start_minute % 64 : 0;
+            int high = word == last ? (end_minute - 1) % 64 : 63;
+            uint64_t mask = (high == 63 ? ~0ULL : (1ULL << (high + 1)) - 1) & ~((1ULL << low) - 1);
+            if (!visit(word, mask)) return false;
+        }
+        return true;
+    }
+
+    bool isFree(Classroom* classroom, int day, int start_minute, int end_minute) {
+        auto room = occupied.find(classroom);
+        if (room == occupied.end()) return true;
+        uint64_t* minutes = room->second.minutes[day];
+        return forEachWord(start_minute, end_minute, [minutes](int word, uint64_t mask) { return (minutes[word] & mask) == 0; });
+    }
+
+    void mark(Classroom* classroom, int day, int start_minute, int end_minute, bool busy) {
+        uint64_t* minutes = occupied[classroom].minutes[day];
+        forEachWord(start_minute, end_minute, [minutes, busy](int word, uint64_t mask) {
+            if (busy) minutes[word] |= mask;
+            else minutes[word] &= ~mask;
+            return true;
+        });
+    }
+
+    static bool validSlot(int day, int start_minute, int end_minute) {
+        return day >= 0 && day < DAYS && start_minute >= 0 && start_minute < end_minute && end_minute <= MINUTES_PER_DAY;
+    }
+
+    // Adds without printing; false if the slot is invalid or the room is taken.
+    bool insertTimeSlot(int day, int start_minute, int end_minute, Course* course, Classroom* classroom) {
+        if (!validSlot(day, start_minute, end_minute) || !isFree(classroom, day, start_minute, end_minute)) return false;
+        mark(classroom, day, start_minute, end_minute, true);
+
+        uint32_t handle;
+        if (!free_handles.empty()) {
+            handle = free_handles.back();
+            free_handles.pop_back();
+        } else {
+            handle = slab.size();
+            slab.emplace_back();
+        }
+        vector<uint32_t>& course_slots = by_course[course];
+        vector<uint32_t>& classroom_slots = by_classroom[classroom];
+        slab[handle] = {{day, start_minute, end_minute, course, classroom}, (uint32_t)course_slots.size(), (uint32_t)classroom_slots.size(),
+                        last_handle, NO_HANDLE};
+        course_slots.push_back(handle);
+        classroom_slots.push_back(handle);
+        if (last_handle != NO_HANDLE) slab[last_handle].next = handle;
+        else first_handle = handle;
+        last_handle = handle;
+        slot_count++;
+        return true;
+    }
+
+    void eraseTimeSlot(uint32_t handle) {
+        SlabEntry& entry = slab[handle];
+        mark(entry.slot.classroom, entry.slot.day, entry.slot.start_minute, entry.slot.end_minute, false);
+
+        // Erased in place so the per-course and per-room lists keep insertion
+        // order; they hold one course's or room's slots and stay short.
+        vector<uint32_t>& course_slots = by_course[entry.slot.course];
+        course_slots.erase(course_slots.begin() + entry.course_position);
+        for (size_t i = entry.course_position; i < course_slots.size(); i++) slab[course_slots[i]].course_position = i;
+        vector<uint32_t>& classroom_slots = by_classroom[entry.slot.classroom];
+        classroom_slots.erase(classroom_slots.begin() + entry.classroom_position);
+        for (size_t i = entry.classroom_position; i < classroom_slots.size(); i++) slab[classroom_slots[i]].classroom_position = i;
+
+        if (entry.previous != NO_HANDLE) slab[entry.previous].next = entry.next;
+        else first_handle = entry.next;
+        if (entry.next != NO_HANDLE) slab[entry.next].previous = entry.previous;
+        else last_handle = entry.previous;
+        free_handles.push_back(handle);
+        slot_count--;
+    }
+public:
+    // Read-only view of a course's or classroom's slots. Valid until the next
+    // add or remove on the schedule.
+    class SlotView {
+    private:
+        const SlabEntry* entries;
+        const uint32_t* first;
+        const uint32_t* last;
+    public:
+        class iterator {
+        private:
+            const SlabEntry* entries;
+            const uint32_t* at;
+        public:
+            iterator(const SlabEntry* entries, const uint32_t* at) : entries(entries), at(at) {}
+            const TimeSlot& operator*() const { return entries[*at].slot; }
+            const TimeSlot* operator->() const { return &entries[*at].slot; }
+            iterator& operator++() { ++at; return *this; }
+            bool operator!=(const iterator& other) const { return at != other.at; }
+            bool operator==(const iterator& other) const { return at == other.at; }
+        };
+
+        SlotView(const SlabEntry* entries = nullptr, const uint32_t* first = nullptr, const uint32_t* last = nullptr)
+            : entries(entries), first(first), last(last) {}
+        iterator begin() const { return iterator(entries, first); }
+        iterator end() const { return iterator(entries, last); }
+        size_t size() const { return last - first; }
+        bool empty() const { return first == last; }
+        const TimeSlot& operator[](size_t i) const { return entries[first[i]].slot; }
+    };
+
+    Schedule() {}
+
+    static string_view trim(string_view text) {
+        while (!text.empty() && isspace((unsigned char)text.front())) text.remove_prefix(1);
+        while (!text.empty() && isspace((unsigned char)text.back())) text.remove_suffix(1);
+        return text;
+    }
+
+    // A day name or any start of one from two letters on ("Mo", "Tue", "Thurs"),
+    // any case, with surrounding spaces ignored; -1 if not a day.
+    static int parseDay(string_view day) {
+        static const char* names[DAYS] = {"monday", "tuesday", "wednesday", "thursday", "friday", "saturday", "sunday"};
+        day = trim(day);
+        if (day.size() < 2) return -1;
+        for (int d = 0; d < DAYS; d++) {
+            if (day.size() > strlen(names[d])) continue;
+            bool match = true;
+            for (size_t i = 0; i < day.size() && match; i++) match = tolower((unsigned char)day[i]) == names[d][i];
+            if (match) return d;
+        }
+        return -1;
+    }
+
+    // "H:MM" or "HH:MM" to minutes since midnight ("24:00" is allowed as an end),
+    // with surrounding spaces ignored; -1 if invalid.
+    static int parseTime(string_view time) {
+        time = trim(time);
+        size_t colon = time.find(':');
+        if (colon == string_view::npos || colon == 0 || colon > 2 || time.size() != colon + 3) return -1;
+        int hours = 0, minutes = 0;
+        for (size_t i = 0; i < time.size(); i++) {
+            if (i == colon) continue;
+            if ((unsigned)(time[i] - '0') > 9) return -1;
+            if (i < colon) hours = hours * 10 + (time[i] - '0');
+            else minutes = minutes * 10 + (time[i] - '0');
+        }
+        if (minutes > 59 || hours > 24 || (hours == 24 && minutes != 0)) return -1;
+        return hours * 60 + minutes;
+    }
+
+    static string dayName(int day) {
+        static const char* names[DAYS] = {"Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday"};
+        return day >= 0 && day < DAYS ? names[day] : "";
+    }
+
+    static string formatTime(int minutes) {
+        char text[8];
+        snprintf(text, sizeof(text), "%02d:%02d", minutes / 60 % 100, minutes % 60);
+        return text;
+    }
+
+    bool addTimeSlot(const string& day, const string& start_time, const string& end_time, Course* course, Classroom* classroom) {
+        int day_index = parseDay(day), start_minute = parseTime(start_time), end_minute = parseTime(end_time);
+        if (!validSlot(day_index, start_minute, end_minute)) {
+            cout << "Invalid Day or Time!\nTime Slot Not Added!\n";
+            return false;
+        }
+        return addTimeSlot(day_index, start_minute, end_minute, course, classroom);
+    }
+
+    bool addTimeSlot(int day, int start_minute, int end_minute, Course* course, Classroom* classroom) {
+        if (!validSlot(day, start_minute, end_minute)) {
+            cout << "Invalid Day or Time!\nTime Slot Not Added!\n";
+            return false;
+        }
+        if (!insertTimeSlot(day, start_minute, end_minute, course, classroom)) {
+            cout << "Time Slot Conflict in Room " << classroom->getClassroomRoomNumber() << "!\nTime Slot Not Added!\n";
+            return false;
+        }
+        cout << "Time Slot Added Successfully!\n";
+        return true;
+    }
+
+    // True if the room has nothing booked in [start_minute, end_minute) on that day.
+    bool isClassroomFree(Classroom* classroom, int day, int start_minute, int end_minute) {
+        return validSlot(day, start_minute, end_minute) && isFree(classroom, day, start_minute, end_minute);
+    }
+    
+    void removeTimeSlot(const string& day, const string& start_time, Course* course) {
+        int day_index = parseDay(day), start_minute = parseTime(start_time);
+        auto course_slots = by_course.find(course);
+        if (course_slots != by_course.end()) {
+            for (uint32_t handle : course_slots->second) {
+                const TimeSlot& slot = slab[handle].slot;
+                if (slot.day == day_index && slot.start_minute == start_minute) {
+                    eraseTimeSlot(handle);
+                    cout << "Time Slot Removed Successfully!\n";
+                    return;
+                }
+            }
+        }
+        cout << "Time Slot Not Found!\n";
+    }
+    
+    // In the order the slots were added.
+    SlotView getCourseSchedule(Course* course) {
+        auto course_slots = by_course.find(course);
+        if (course_slots == by_course.end()) return SlotView();
+        const vector<uint32_t>& handles = course_slots->second;
+        return SlotView(slab.data(), handles.data(), handles.data() + handles.size());
+    }
+    
+    SlotView getClassroomSchedule(Classroom* classroom) {
+        auto classroom_slots = by_classroom.find(classroom);
+        if (classroom_slots == by_classroom.end()) return SlotView();
+        const vector<uint32_t>& handles = classroom_slots->second;
+        return SlotView(slab.data(), handles.data(), handles.data() + handles.size());
+    }
+
+    // In the order the slots were added.
+    template <typename Visitor>
+    void forEachTimeSlot(Visitor visit) {
+        for (uint32_t handle = first_handle; handle != NO_HANDLE; handle = slab[handle].next) {
+            visit(slab[handle].slot);
+        }
+    }
+
+    size_t getTimeSlotCount() {
+        return slot_count;
+    }
+    
+    void displaySchedule() {
+        if (slot_count == 0) {
+            cout << "No Time Slots in Schedule!\n";
+            return;
+        }
+        cout << "Schedule:\n";
+        cout << "Day\tStart\tEnd\tCourse\tRoom\n";
+        forEachTimeSlot([](const TimeSlot& slot) {
+            cout << dayName(slot.day) << "\t" 
+                 << formatTime(slot.start_minute) << "\t" 
+                 << formatTime(slot.end_minute) << "\t" 
+                 << slot.course->getCourseCode() << "\t" 
+                 << slot.classroom->getClassroomRoomNumber() << "\n";
+        });
+    }
+};
+
+// Assigns course meetings to classrooms on a weekly grid of fixed periods.
+// Hard constraints: a room holds one meeting per period and must seat the
+// course (and have a projector when asked for); meetings of one course, of
+// courses sharing an instructor, and of courses sharing a student never
+// overlap; instructors only teach in periods they are available. Spreading a
+// course's meetings over different days is preferred but not required.
+//
+// Periods are bits of a uint64_t, so domains, room occupancy and availability
+// are all single-word bitsets. A greedy pass with forward checking places
+// the most constrained courses first. Several simulated annealing chains then
+// improve that start in parallel and the best one is kept. Every state is
+// conflict-free: a meeting that cannot be fitted is reported as unplaced.
+class TimetableSolver {
+public:
+    struct Options {
+        int days = 5;
+        int periods_per_day = 8;
+        int period_minutes = 60;
+        int day_start_minute = 9 * 60;
+        unsigned threads = 0;
+        size_t iterations = 0;
+        uint64_t seed = 1;
+    };
+
+    struct Assignment {
+        Course* course;
+        Classroom* classroom;
+        int day;
+        int start_minute;
+        int end_minute;
+    };
+
+    struct Result {
+        vector<Assignment> assignments;
+        size_t meetings = 0;
+        size_t unplaced = 0;
+        size_t same_day_repeats = 0;
+        double seconds = 0;
+
+        void display() {
+            cout << "Placed " << assignments.size() << " of " << meetings << " Meetings in " << seconds * 1000 << " ms\n";
+            cout << "Unplaced Meetings: " << unplaced << "\n";
+            cout << "Same Day Repeats: " << same_day_repeats << "\n";
+        }
+    };
+private:
+    static const int MAX_PERIODS = 64;
+    static const long long UNPLACED = 100, SOFT = 5;
+
+    struct CourseInfo {
+        Course* course;
+        int meetings;
+        bool needs_projector;
+        uint64_t available = 0;
+        vector<uint32_t> rooms;
+        vector<uint32_t> neighbors;
+    };
+
+    // A conflict-free partial timetable. course_slot and room_slot give the
+    // meeting holding each (course, period) and (room, period), or -1; the
+    // unplaced meetings wait in pool.
+    struct State {
+        vector<int> period;
+        vector<int> room;
+        vector<int> course_slot;
+        vector<int> room_slot;
+        vector<uint8_t> course_day_load;
+        vector<uint32_t> pool;
+        vector<uint32_t> pool_index;
+        long long cost = 0;
+    };
+
+    Options options;
+    int period_count;
+    vector<CourseInfo> courses;
+    vector<Classroom*> classrooms;
+    unordered_map<Professor*, uint64_t> availability;
+    vector<uint32_t> meeting_course;
+
+    int dayOf(int period) const {
+        return period / options.periods_per_day;
+    }
+
+    uint64_t gridMask() const {
+        return period_count == 64 ? ~0ULL : (1ULL << period_count) - 1;
+    }
+
+    static int randomBit(uint64_t bits, uint64_t random) {
+        int skip = random % __builtin_popcountll(bits);
+        while (skip-- > 0) bits &= bits - 1;
+        return __builtin_ctzll(bits);
+    }
+
+    void prepare() {
+        meeting_course.clear();
+        unordered_map<int, vector<uint32_t>> by_student;
+        unordered_map<Professor*, vector<uint32_t>> by_instructor;
+        vector<int> enrolled(courses.size());
+        for (uint32_t c = 0; c < courses.size(); c++) {
+            CourseInfo& info = courses[c];
+            vector<Student*> students = info.course->getEnrolledStudents();
+            enrolled[c] = students.size();
+            for (auto student : students) by_student[student->getPersonID()].push_back(c);
+
+            info.available = gridMask();
+            Professor* instructor = info.course->getCourseInstructor();
+            if (instructor != nullptr) {
+                by_instructor[instructor].push_back(c);
+                auto hours = availability.find(instructor);
+                if (hours != availability.end()) info.available &= hours->second;
+            }
+            for (int m = 0; m < info.meetings; m++) meeting_course.push_back(c);
+        }
+
+        // Smallest fitting rooms first, so the greedy pass leaves large rooms free.
+        vector<uint32_t> by_capacity(classrooms.size());
+        for (uint32_t r = 0; r < classrooms.size(); r++) by_capacity[r] = r;
+        sort(by_capacity.begin(), by_capacity.end(), [this](uint32_t a, uint32_t b) {
+            return classrooms[a]->getClassroomCapacity() < classrooms[b]->getClassroomCapacity();
+        });
+        for (uint32_t c = 0; c < courses.size(); c++) {
+            CourseInfo& info = courses[c];
+            info.rooms.clear();
+            info.neighbors.clear();
+            for (uint32_t r : by_capacity) {
+                if (classrooms[r]->getClassroomCapacity() >= enrolled[c] && (!info.needs_projector || classrooms[r]->getClassroomHasProjector())) {
+                    info.rooms.push_back(r);
+                }
+            }
+        }
+
+        auto link = [this](const vector<uint32_t>& group) {
+            for (size_t i = 0; i < group.size(); i++) {
+                for (size_t j = i + 1; j < group.size(); j++) {
+                    courses[group[i]].neighbors.push_back(group[j]);
+                    courses[group[j]].neighbors.push_back(group[i]);
+                }
+            }
+        };
+        for (auto& student : by_student) link(student.second);
+        for (auto& instructor : by_instructor) link(instructor.second);
+        for (auto& info : courses) {
+            sort(info.neighbors.begin(), info.neighbors.end());
+            info.neighbors.erase(unique(info.neighbors.begin(), info.neighbors.end()), info.neighbors.end());
+        }
+    }
+
+    void initState(State& state) const {
+        size_t meetings = meeting_course.size();
+        state.period.assign(meetings, -1);
+        state.room.assign(meetings, -1);
+        state.course_slot.assign(courses.size() * MAX_PERIODS, -1);
+        state.room_slot.assign(classrooms.size() * MAX_PERIODS, -1);
+        state.course_day_load.assign(courses.size() * Schedule::DAYS, 0);
+        state.pool.resize(meetings);
+        state.pool_index.resize(meetings);
+        for (uint32_t m = 0; m < meetings; m++) {
+            state.pool[m] = m;
+            state.pool_index[m] = m;
+        }
+        state.cost = UNPLACED * meetings;
+    }
+
+    // The caller makes sure (period, room) is free of conflicts for m.
+    void place(State& state, uint32_t m, int period, int room) const {
+        uint32_t c = meeting_course[m];
+        uint8_t& day_load = state.course_day_load[c * Schedule::DAYS + dayOf(period)];
+        state.cost += SOFT * day_load - UNPLACED;
+        day_load++;
+        state.period[m] = period;
+        state.room[m] = room;
+        state.course_slot[c * MAX_PERIODS + period] = m;
+        state.room_slot[room * MAX_PERIODS + period] = m;
+
+        uint32_t last = state.pool.back();
+        state.pool[state.pool_index[m]] = last;
+        state.pool_index[last] = state.pool_index[m];
+        state.pool.pop_back();
+    }
+
+    void unplace(State& state, uint32_t m) const {
+        uint32_t c = meeting_course[m];
+        int period = state.period[m];
+        uint8_t& day_load = state.course_day_load[c * Schedule::DAYS + dayOf(period)];
+        day_load--;
+        state.cost += UNPLACED - SOFT * day_load;
+        state.course_slot[c * MAX_PERIODS + period] = -1;
+        state.room_slot[state.room[m] * MAX_PERIODS + period] = -1;
+        state.period[m] = -1;
+        state.room[m] = -1;
+
+        state.pool_index[m] = state.pool.size();
+        state.pool.push_back(m);
+    }
+
+    // Meetings that would have to make way for m at (period, room).
+    void collectClashes(const State& state, uint32_t m, int period, int room, vector<uint32_t>& clashes) const {
+        clashes.clear();
+        uint32_t c = meeting_course[m];
+        int own = state.course_slot[c * MAX_PERIODS + period];
+        if (own >= 0 && (uint32_t)own != m) clashes.push_back(own);
+        for (uint32_t n : courses[c].neighbors) {
+            int other = state.course_slot[n * MAX_PERIODS + period];
+            if (other >= 0) clashes.push_back(other);
+        }
+        int occupant = state.room_slot[room * MAX_PERIODS + period];
+        if (occupant >= 0 && (uint32_t)occupant != m && find(clashes.begin(), clashes.end(), (uint32_t)occupant) == clashes.end()) {
+            clashes.push_back(occupant);
+        }
+    }
+
+    // Always continues with the course that has the least slack left, counted
+    // as open periods minus meetings still to place. Each period taken is
+    // removed from the domains of the course and its neighbours. A meeting
+    // goes in a period some fitting room still has free. Days the course has
+    // not used come first; after that, the period least needed by neighbours
+    // that are still being placed.
+    void greedy(State& state) const {
+        size_t course_count = courses.size();
+        vector<uint64_t> domain(course_count);
+        vector<int> remaining(course_count);
+        vector<uint32_t> next_meeting(course_count);
+        vector<uint64_t> used_days(course_count, 0);
+        vector<uint64_t> room_busy(classrooms.size(), 0);
+        uint32_t first = 0;
+        for (uint32_t c = 0; c < course_count; c++) {
+            domain[c] = courses[c].available;
+            remaining[c] = courses[c].rooms.empty() ? 0 : courses[c].meetings;
+            next_meeting[c] = first;
+            first += courses[c].meetings;
+        }
+
+        while (true) {
+            int chosen = -1, chosen_slack = 0;
+            for (uint32_t c = 0; c < course_count; c++) {
+                if (remaining[c] == 0) continue;
+                int slack = __builtin_popcountll(domain[c]) - remaining[c];
+                if (chosen < 0 || slack < chosen_slack ||
+                    (slack == chosen_slack && courses[c].neighbors.size() > courses[chosen].neighbors.size())) {
+                    chosen = c;
+                    chosen_slack = slack;
+                }
+            }
+            if (chosen < 0) break;
+            const CourseInfo& info = courses[chosen];
+
+            uint64_t room_free = 0;
+            for (uint32_t r : info.rooms) room_free |= ~room_busy[r];
+            uint64_t feasible = domain[chosen] & room_free;
+            if (feasible == 0) {
+                remaining[chosen] = 0;
+                continue;
+            }
+
+            int period = -1;
+            long long best_score = 0;
+            for (uint64_t bits = feasible; bits != 0; bits &= bits - 1) {
+                int p = __builtin_ctzll(bits);
+                long long score = (used_days[chosen] >> dayOf(p) & 1) ? 1LL << 32 : 0;
+                for (uint32_t n : info.neighbors) {
+                    if (remaining[n] != 0 && (domain[n] >> p & 1)) score += remaining[n];
+                }
+                if (period < 0 || score < best_score) {
+                    period = p;
+                    best_score = score;
+                }
+            }
+            int room = -1;
+            for (uint32_t r : info.rooms) {
+                if (!(room_busy[r] >> period & 1)) {
+                    room = r;
+                    break;
+                }
+            }
+            place(state, next_meeting[chosen]++, period, room);
+            remaining[chosen]--;
+            room_busy[room] |= 1ULL << period;
+            used_days[chosen] |= 1ULL << dayOf(period);
+            domain[chosen] &= ~(1ULL << period);
+            for (uint32_t n : info.neighbors) domain[n] &= ~(1ULL << period);
+        }
+    }
+
+    // Each step moves one meeting, usually an unplaced one, to a random period
+    // in its domain, preferring a free fitting room. Whatever clashes with it
+    // there goes back to the pool, so every state stays conflict-free, and
+    // the step is kept under the usual annealing rule. Recently ejected
+    // meetings may not return to the same period for a few steps, which stops
+    // two meetings swapping places back and forth.
+    void anneal(State& state, size_t iterations, uint64_t seed) const {
+        mt19937_64 random(seed);
+        uniform_real_distribution<double> chance(0.0, 1.0);
+        const double start_temperature = UNPLACED / 2.0, end_temperature = 0.5;
+        vector<int> best_period = state.period, best_room = state.room;
+        long long best_cost = state.cost;
+        vector<uint32_t> tabu(meeting_course.size() * MAX_PERIODS, 0);
+        vector<uint32_t> clashes;
+        double temperature = start_temperature;
+
+        for (size_t i = 1; i <= iterations; i++) {
+            if ((i & 255) == 0) {
+                temperature = start_temperature * pow(end_temperature / start_temperature, (double)i / iterations);
+                if (state.cost < best_cost) {
+                    best_cost = state.cost;
+                    best_period = state.period;
+                    best_room = state.room;
+                }
+            }
+            uint32_t m = !state.pool.empty() && (random() & 3) != 0 ? state.pool[random() % state.pool.size()]
+                                                                    : random() % meeting_course.size();
+            uint32_t c = meeting_course[m];
+            const CourseInfo& info = courses[c];
+            if (info.rooms.empty() || info.available == 0) continue;
+
+            int period = randomBit(info.available, random());
+            if (period == state.period[m] || tabu[m * MAX_PERIODS + period] > i) continue;
+            int room = info.rooms[random() % info.rooms.size()];
+            for (int tries = 0; tries < 4 && state.room_slot[room * MAX_PERIODS + period] >= 0; tries++) {
+                room = info.rooms[random() % info.rooms.size()];
+            }
+            collectClashes(state, m, period, room, clashes);
+
+            // Cost change: clashes return to the pool, m leaves it (or moves),
+            // and the same-day counts shift.
+            long long delta = UNPLACED * clashes.size();
+            for (uint32_t other : clashes) {
+                uint32_t o = meeting_course[other];
+                delta -= SOFT * (state.course_day_load[o * Schedule::DAYS + dayOf(state.period[other])] - 1);
+            }
+            int old_day = state.period[m] >= 0 ? dayOf(state.period[m]) : -1;
+            int new_load = state.course_day_load[c * Schedule::DAYS + dayOf(period)] - (old_day == dayOf(period) ? 1 : 0);
+            delta += SOFT * new_load;
+            if (old_day >= 0) delta -= SOFT * (state.course_day_load[c * Schedule::DAYS + old_day] - 1);
+            else delta -= UNPLACED;
+            if (delta > 0 && chance(random) >= exp(-delta / temperature)) continue;
+
+            for (uint32_t other : clashes) {
+                tabu[other * MAX_PERIODS + state.period[other]] = i + 10 + random() % 10;
+                unplace(state, other);
+            }
+            if (state.period[m] >= 0) unplace(state, m);
+            place(state, m, period, room);
+        }
+        if (best_cost < state.cost) {
+            initState(state);
+            for (uint32_t m = 0; m < meeting_course.size(); m++) {
+                if (best_period[m] >= 0) place(state, m, best_period[m], best_room[m]);
+            }
+        }
+    }
+
+    Result finish(const State& state) const {
+        Result result;
+        result.meetings = meeting_course.size();
+        result.unplaced = state.pool.size();
+        for (uint32_t m = 0; m < meeting_course.size(); m++) {
+            int period = state.period[m];
+            if (period < 0) continue;
+            uint32_t c = meeting_course[m];
+            int start = options.day_start_minute + (period % options.periods_per_day) * options.period_minutes;
+            result.assignments.push_back({courses[c].course, classrooms[state.room[m]], dayOf(period), start, start + options.period_minutes});
+        }
+        for (uint32_t c = 0; c < courses.size(); c++) {
+            for (int d = 0; d < Schedule::DAYS; d++) {
+                int load = state.course_day_load[c * Schedule::DAYS + d];
+                if (load > 1) result.same_day_repeats += load * (load - 1) / 2;
+            }
+        }
+        return result;
+    }
+public:
+    TimetableSolver() : TimetableSolver(Options()) {}
+    TimetableSolver(Options options) {
+        if (options.days < 1 || options.days > Schedule::DAYS || options.periods_per_day < 1 || options.period_minutes < 1 ||
+            options.days * options.periods_per_day > MAX_PERIODS || options.day_start_minute < 0 ||
+            options.day_start_minute + options.periods_per_day * options.period_minutes > Schedule::MINUTES_PER_DAY) {
+            throw UniversitySystemException("Timetable grid must fit in one day and at most 64 periods a week", 800);
+        }
+        this->options = options;
+        this->period_count = options.days * options.periods_per_day;
+    }
+
+    // meetings defaults to the course credits rounded up, at most one a day.
+    void addCourse(Course* course, int meetings = 0, bool needs_projector = false) {
+        if (meetings <= 0) meetings = min(options.days, max(1, (int)ceil(course->getCourseCredits())));
+        CourseInfo info;
+        info.course = course;
+        info.meetings = meetings;
+        info.needs_projector = needs_projector;
+        courses.push_back(info);
+    }
+
+    void addClassroom(Classroom* classroom) {
+        classrooms.push_back(classroom);
+    }
+
+    // Bit periodBit(day, period) set means the professor can teach then.
+    void setProfessorAvailability(Professor* professor, uint64_t periods) {
+        availability[professor] = periods;
+    }
+
+    uint64_t periodBit(int day, int period) const {
+        return 1ULL << (day * options.periods_per_day + period);
+    }
+
+    Result solve() {
+        auto start = chrono::steady_clock::now();
+        prepare();
+        State initial;
+        initState(initial);
+        greedy(initial);
+
+        size_t iterations = options.iterations != 0 ? options.iterations : 2000 * meeting_course.size();
+        unsigned chains = options.threads == 0 ? max(1u, thread::hardware_concurrency()) : options.threads;
+        if (meeting_course.empty()) return finish(initial);
+        vector<State> results(chains, initial);
+        vector<thread> workers;
+        for (unsigned t = 1; t < chains; t++) {
+            workers.emplace_back([this, &results, iterations, t]() { anneal(results[t], iterations, options.seed + t); });
+        }
+        anneal(results[0], iterations, options.seed);
+        for (auto& worker : workers) worker.join();
+
+        size_t best = 0;
+        for (size_t t = 1; t < chains; t++) {
+            if (results[t].cost < results[best].cost) best = t;
+        }
+        Result result = finish(results[best]);
+        result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    // Adds the assignments to schedule quietly; returns how many fitted
+    // around what the schedule already held.
+    size_t apply(const Result& result, Schedule& schedule) {
+        size_t added = 0;
+        for (const auto& assignment : result.assignments) {
+            added += schedule.insertTimeSlot(assignment.day, assignment.start_minute, assignment.end_minute, assignment.course, assignment.classroom);
+        }
+        return added;
+    }
+};
+
+// Everything a snapshot covers. On save the pointers are only read; on load
+// every object is freshly allocated and owned by the caller (see release()).
+struct UniversityState {
+    University* university = nullptr;
+    vector<Department*> departments;
+    vector<Person*> people;
+    vector<Course*> courses;
+    vector<Classroom*> classrooms;
+    vector<GradeBook*> gradebooks;
+    EnrollmentManager* enrollments = nullptr;
+    Schedule* schedule = nullptr;
+
+    void release() {
+        for (auto person : people) delete person;
+        for (auto course : courses) delete course;
+        for (auto classroom : classrooms) delete classroom;
+        for (auto book : gradebooks) delete book;
+        for (auto department : departments) delete department;
+        delete enrollments;
+        delete schedule;
+        delete university;
+        *this = UniversityState();
+    }
+};
+
+// Snapshot file layout. The header lists one section per record type. Each
+// section is an array of fixed-size records at an 8-byte aligned offset from
+// the start of the file. Records refer to strings and to each other by index,
+// and lists are (first, count) ranges into SNAP_INDICES, so a mapped file can
+// be read in place without parsing.
+enum SnapshotSectionID {
+    SNAP_STRINGS, SNAP_STRING_DATA, SNAP_INDICES, SNAP_PEOPLE, SNAP_DEPARTMENTS,
+    SNAP_UNIVERSITY, SNAP_COURSES, SNAP_CLASSROOMS, SNAP_GRADEBOOKS, SNAP_GRADE_IDS,
+    SNAP_GRADE_VALUES, SNAP_ENROLLMENTS, SNAP_TIME_SLOTS, SNAP_SECTION_COUNT
+};
+
+const uint32_t SNAP_HAS_ENROLLMENTS = 1, SNAP_HAS_SCHEDULE = 2;
+
+struct SnapshotSection { uint64_t offset; uint64_t count; };
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t sectionCount;
+    uint64_t fileSize;
+    uint32_t flags;
+    uint32_t reserved;
+    SnapshotSection sections[SNAP_SECTION_COUNT];
+};
+struct SnapshotString { uint32_t offset; uint32_t length; };
+struct SnapshotRange { uint32_t first; uint32_t count; };
+
+// What text/numbers/amounts/flags hold depends on kind; see UniversitySnapshot::encodePerson.
+struct SnapshotPerson {
+    uint32_t kind;
+    uint32_t name;
+    int32_t ageID;
+    int32_t ID;
+    int64_t contact;
+    uint32_t text[5];
+    int32_t numbers[3];
+    double amounts[2];
+    uint32_t flags;
+    int32_t advisor;
+};
+struct SnapshotDepartment { uint32_t name; uint32_t location; double budget; SnapshotRange professors; };
+struct SnapshotUniversity { uint32_t name; uint32_t location; SnapshotRange departments; };
+struct SnapshotCourse {
+    uint32_t code, title, description, deadline;
+    double credits;
+    int32_t maxCapacity;
+    int32_t waitlistCapacity;
+    int32_t instructor;
+    SnapshotRange students;
+    SnapshotRange waitlist;
+};
+struct SnapshotClassroom { uint32_t roomNumber; uint32_t building; int32_t capacity; uint32_t hasProjector; };
+struct SnapshotGradeBook { uint32_t courseCode; SnapshotRange grades; };
+struct SnapshotEnrollment { uint32_t courseCode; uint32_t studentID; };
+struct SnapshotTimeSlot { uint32_t day, startMinute, endMinute; int32_t course, classroom; };
+
+// A whole file mapped read-only into memory.
+class MappedFile {
+private:
+    const char* base = nullptr;
+    size_t length = 0;
+public:
+    MappedFile() {}
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    bool open(const string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            return false;
+        }
+        void* mapped = info.st_size > 0 ? mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+        ::close(fd);
+        if (mapped == MAP_FAILED) return false;
+        base = (const char*)mapped;
+        length = info.st_size;
+        return true;
+    }
+
+    void close() {
+        if (base != nullptr) munmap((void*)base, length);
+        base = nullptr;
+        length = 0;
+    }
+
+    const char* data() { return base; }
+    size_t size() { return length; }
+};
+
+// Read-only view of a snapshot file mapped with mmap. open() only checks the
+// header and section bounds; records are read straight out of the mapping.
+class SnapshotView {
+private:
+    MappedFile file;
+    const char* base = nullptr;
+    size_t size = 0;
+    const SnapshotHeader* header = nullptr;
+
+    bool validate() {
+        if (memcmp(header->magic, "UNISNAP", 8) != 0) return false;
+        if (header->version != VERSION || header->sectionCount != SNAP_SECTION_COUNT) return false;
+        if (header->fileSize != size) return false;
+        for (int id = 0; id < SNAP_SECTION_COUNT; id++) {
+            const SnapshotSection& section = header->sections[id];
+            if (section.offset % 8 != 0 || section.offset > size) return false;
+            if (section.count > (size - section.offset) / recordSize((SnapshotSectionID)id)) return false;
+        }
+        return true;
+    }
+public:
+    static const uint32_t VERSION = 3;
+
+    static size_t recordSize(SnapshotSectionID id) {
+        switch (id) {
+            case SNAP_STRINGS: return sizeof(SnapshotString);
+            case SNAP_STRING_DATA: return 1;
+            case SNAP_INDICES: return sizeof(uint32_t);
+            case SNAP_PEOPLE: return sizeof(SnapshotPerson);
+            case SNAP_DEPARTMENTS: return sizeof(SnapshotDepartment);
+            case SNAP_UNIVERSITY: return sizeof(SnapshotUniversity);
+            case SNAP_COURSES: return sizeof(SnapshotCourse);
+            case SNAP_CLASSROOMS: return sizeof(SnapshotClassroom);
+            case SNAP_GRADEBOOKS: return sizeof(SnapshotGradeBook);
+            case SNAP_GRADE_IDS: return sizeof(uint32_t);
+            case SNAP_GRADE_VALUES: return 1;
+            case SNAP_ENROLLMENTS: return sizeof(SnapshotEnrollment);
+            case SNAP_TIME_SLOTS: return sizeof(SnapshotTimeSlot);
+            default: return 1;
+        }
+    }
+
+    SnapshotView() {}
+    SnapshotView(const SnapshotView&) = delete;
+    SnapshotView& operator=(const SnapshotView&) = delete;
+    ~SnapshotView() { close(); }
+
+    bool open(const string& path) {
+        close();
+        if (!file.open(path)) return false;
+        base = file.data();
+        size = file.size();
+        header = (const SnapshotHeader*)base;
+        if (size < sizeof(SnapshotHeader) || !validate()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        file.close();
+        base = nullptr;
+        size = 0;
+        header = nullptr;
+    }
+
+    uint32_t getFlags() { return header->flags; }
+    size_t count(SnapshotSectionID id) { return header->sections[id].count; }
+
+    template <typename T>
+    const T* records(SnapshotSectionID id) {
+        return (const T*)(base + header->sections[id].offset);
+    }
+
+    string_view text(uint32_t index) {
+        if (index >= count(SNAP_STRINGS)) throw UniversitySystemException("Snapshot string index out of range", 601);
+        const SnapshotString& entry = records<SnapshotString>(SNAP_STRINGS)[index];
+        if ((uint64_t)entry.offset + entry.length > count(SNAP_STRING_DATA)) {
+            throw UniversitySystemException("Snapshot string out of range", 601);
+        }
+        return string_view(records<char>(SNAP_STRING_DATA) + entry.offset, entry.length);
+    }
+
+    // Checks that range fits in a section holding limit records.
+    void checkRange(SnapshotRange range, size_t limit) {
+        if ((uint64_t)range.first + range.count > limit) throw UniversitySystemException("Snapshot range out of bounds", 601);
+    }
+
+    uint32_t index(SnapshotRange range, uint32_t i) {
+        checkRange(range, count(SNAP_INDICES));
+        return records<uint32_t>(SNAP_INDICES)[range.first + i];
+    }
+};
+
+class UniversitySnapshot {
+private:
+    struct Writer {
+        vector<SnapshotString> strings;
+        string stringData;
+        unordered_map<string, uint32_t> stringIndex;
+        vector<uint32_t> indices;
+        vector<Person*> people;
+        unordered_map<Person*, int32_t> personIndex;
+        vector<Department*> departments;
+        unordered_map<Department*, int32_t> departmentIndex;
+        vector<Course*> courses;
+        unordered_map<Course*, int32_t> courseIndex;
+        vector<Classroom*> classrooms;
+        unordered_map<Classroom*, int32_t> classroomIndex;
+
+        uint32_t addString(const string& text) {
+            auto found = stringIndex.emplace(text, strings.size());
+            if (found.second) {
+                strings.push_back({(uint32_t)stringData.size(), (uint32_t)text.size()});
+                stringData += text;
+            }
+            return found.first->second;
+        }
+
+        SnapshotRange addIndices(const vector<uint32_t>& list) {
+            SnapshotRange range = {(uint32_t)indices.size(), (uint32_t)list.size()};
+            indices.insert(indices.end(), list.begin(), list.end());
+            return range;
+        }
+
+        int32_t addPerson(Person* person) {
+            if (person == nullptr) return -1;
+            auto found = personIndex.emplace(person, people.size());
+            if (found.second) {
+                people.push_back(person);
+                if (auto graduate = dynamic_cast<GraduateStudent*>(person)) addPerson(graduate->getGraduateStudentAdvisor());
+            }
+            return found.first->second;
+        }
+
+        int32_t addDepartment(Department* department) {
+            auto found = departmentIndex.emplace(department, departments.size());
+            if (found.second) {
+                departments.push_back(department);
+                for (auto professor : department->professors) addPerson(professor);
+            }
+            return found.first->second;
+        }
+
+        int32_t addCourse(Course* course) {
+            if (course == nullptr) return -1;
+            auto found = courseIndex.emplace(course, courses.size());
+            if (found.second) {
+                courses.push_back(course);
+                addPerson(course->getCourseInstructor());
+                for (auto student : course->getEnrolledStudents()) addPerson(student);
+            }
+            return found.first->second;
+        }
+
+        int32_t addClassroom(Classroom* classroom) {
+            if (classroom == nullptr) return -1;
+            auto found = classroomIndex.emplace(classroom, classrooms.size());
+            if (found.second) classrooms.push_back(classroom);
+            return found.first->second;
+        }
+    };
+
+    static SnapshotPerson encodePerson(Person* person, Writer& writer) {
+        SnapshotPerson record;
+        memset(&record, 0, sizeof(record));
+        record.kind = KIND_PERSON;
+        record.name = writer.addString(person->getPersonName());
+        record.ageID = person->getPersonAgeID();
+        record.ID = person->getPersonID();
+        record.contact = person->getPersonContact_info();
+        record.advisor = -1;
+
+        if (auto student = dynamic_cast<Student*>(person)) {
+            record.kind = KIND_STUDENT;
+            record.text[0] = writer.addString(student->getStudentEnrollmentDate());
+            record.text[1] = writer.addString(student->getStudentProgram());
+            record.amounts[0] = student->getStudentGPA();
+            if (auto undergraduate = dynamic_cast<UndergraduateStudent*>(person)) {
+                record.kind = KIND_UNDERGRADUATE;
+                record.text[2] = writer.addString(undergraduate->getUndergraduateStudentMajor());
+                record.text[3] = writer.addString(undergraduate->getUndergraduateStudentMinor());
+                record.text[4] = writer.addString(undergraduate->getUndergraduateStudentExpectedGraduationDate());
+            } else if (auto graduate = dynamic_cast<GraduateStudent*>(person)) {
+                record.kind = KIND_GRADUATE;
+                record.text[2] = writer.addString(graduate->getGraduateStudentResearchTopic());
+                record.text[3] = writer.addString(graduate->getGraduateStudentThesisTitle());
+                record.numbers[0] = graduate->getTeachingHours();
+                record.numbers[1] = graduate->getResearchHours();
+                record.amounts[1] = graduate->getAssistantshipStipend();
+                record.flags = (graduate->getTeachingAssistantship() ? 1 : 0) | (graduate->getResearchAssistantship() ? 2 : 0);
+                record.advisor = writer.addPerson(graduate->getGraduateStudentAdvisor());
+            }
+        } else if (auto professor = dynamic_cast<Professor*>(person)) {
+            record.kind = KIND_PROFESSOR;
+            record.text[0] = writer.addString(professor->getProfessorDepartment());
+            record.text[1] = writer.addString(professor->getProfessorHireDate());
+            record.text[2] = writer.addString(professor->getProfessorSpecialization());
+            if (auto assistant = dynamic_cast<AssistantProfessor*>(person)) {
+                record.kind = KIND_ASSISTANT_PROFESSOR;
+                record.numbers[0] = assistant->getAssistantProfessorContractYears();
+                record.numbers[1] = assistant->getAssistantProfessorPapersPublished();
+                record.flags = assistant->getAssistantProfessorPromotionEligible() ? 1 : 0;
+            } else if (auto associate = dynamic_cast<AssociateProfessor*>(person)) {
+                record.kind = KIND_ASSOCIATE_PROFESSOR;
+                record.numbers[0] = associate->getAssociateProfessorTeachingYears();
+                record.numbers[1] = associate->getAssociateProfessorProjectsDone();
+                record.numbers[2] = associate->getAssociateProfessorStudentsGuided();
+            } else if (auto full = dynamic_cast<FullProfessor*>(person)) {
+                record.kind = KIND_FULL_PROFESSOR;
+                record.numbers[0] = full->getFullProfessorWorkYears();
+                record.numbers[1] = full->getFullProfessorForeignPapers();
+                record.flags = full->getFullProfessorIsHead() ? 1 : 0;
+            }
+        }
+        return record;
+    }
+
+    static Person* decodePerson(SnapshotView& view, const SnapshotPerson& record) {
+        auto text = [&view, &record](int i) { return string(view.text(record.text[i])); };
+        string name(view.text(record.name));
+        Person* person = nullptr;
+        switch (record.kind) {
+            case KIND_PERSON:
+                person = new Person();
+                break;
+            case KIND_STUDENT:
+                person = new Student(text(0), text(1), record.amounts[0]);
+                break;
+            case KIND_UNDERGRADUATE:
+                person = new UndergraduateStudent(text(0), text(1), record.amounts[0], text(2), text(3), text(4));
+                break;
+            case KIND_GRADUATE: {
+                GraduateStudent* graduate = new GraduateStudent(text(0), text(1), record.amounts[0], text(2), text(3));
+                graduate->teaching_hours = record.numbers[0];
+                graduate->research_hours = record.numbers[1];
+                graduate->assistantship_stipend = record.amounts[1];
+                graduate->teaching_assistantship = record.flags & 1;
+                graduate->research_assistantship = record.flags & 2;
+                person = graduate;
+                break;
+            }
+            case KIND_PROFESSOR:
+                person = new Professor(text(0), text(1), text(2));
+                break;
+            case KIND_ASSISTANT_PROFESSOR:
+                person = new AssistantProfessor(text(0), text(1), text(2), record.numbers[0], record.numbers[1], record.flags & 1);
+                break;
+            case KIND_ASSOCIATE_PROFESSOR:
+                person = new AssociateProfessor(text(0), text(1), text(2), record.numbers[0], record.numbers[1], record.numbers[2]);
+                break;
+            case KIND_FULL_PROFESSOR:
+                person = new FullProfessor(text(0), text(1), text(2), record.numbers[0], record.numbers[1], record.flags & 1);
+                break;
+            default:
+                throw UniversitySystemException("Unknown person kind in snapshot", 601);
+        }
+        person->name = name;
+        person->ageID = record.ageID;
+        person->ID = record.ID;
+        person->contact_info = record.contact;
+        return person;
+    }
+
+    template <typename T>
+    static T* personAt(const vector<Person*>& people, int32_t index) {
+        if (index < 0) return nullptr;
+        T* person = (size_t)index < people.size() ? dynamic_cast<T*>(people[index]) : nullptr;
+        if (person == nullptr) throw UniversitySystemException("Snapshot person reference has the wrong type", 601);
+        return person;
+    }
+
+    template <typename T>
+    static T* objectAt(const vector<T*>& objects, int32_t index) {
+        if (index < 0) return nullptr;
+        if ((size_t)index >= objects.size()) throw UniversitySystemException("Snapshot reference out of range", 601);
+        return objects[index];
+    }
+
+    template <typename T>
+    static void appendSection(string& file, SnapshotHeader& header, SnapshotSectionID id, const T* data, size_t count) {
+        file.append((8 - file.size() % 8) % 8, '\0');
+        header.sections[id].offset = file.size();
+        header.sections[id].count = count;
+        file.append((const char*)data, count * sizeof(T));
+    }
+
+    static void restore(SnapshotView& view, UniversityState& state) {
+        size_t peopleCount = view.count(SNAP_PEOPLE);
+        const SnapshotPerson* people = view.records<SnapshotPerson>(SNAP_PEOPLE);
+        state.people.reserve(peopleCount);
+        for (size_t i = 0; i < peopleCount; i++) {
+            state.people.push_back(decodePerson(view, people[i]));
+        }
+        for (size_t i = 0; i < peopleCount; i++) {
+            if (people[i].kind == KIND_GRADUATE) {
+                ((GraduateStudent*)state.people[i])->advisor = personAt<Professor>(state.people, people[i].advisor);
+            }
+        }
+
+        const SnapshotDepartment* departments = view.records<SnapshotDepartment>(SNAP_DEPARTMENTS);
+        for (size_t i = 0; i < view.count(SNAP_DEPARTMENTS); i++) {
+            const SnapshotDepartment& record = departments[i];
+            Department* department = new Department(string(view.text(record.name)), string(view.text(record.location)), record.budget);
+            state.departments.push_back(department);
+            for (uint32_t k = 0; k < record.professors.count; k++) {
+                department->insertProfessor(personAt<Professor>(state.people, view.index(record.professors, k)));
+            }
+        }
+
+        if (view.count(SNAP_UNIVERSITY) > 0) {
+            const SnapshotUniversity& record = view.records<SnapshotUniversity>(SNAP_UNIVERSITY)[0];
+            state.university = new University(string(view.text(record.name)), string(view.text(record.location)));
+            for (uint32_t k = 0; k < record.departments.count; k++) {
+                state.university->insertDepartment(objectAt(state.departments, view.index(record.departments, k)));
+            }
+        }
+
+        const SnapshotClassroom* classrooms = view.records<SnapshotClassroom>(SNAP_CLASSROOMS);
+        for (size_t i = 0; i < view.count(SNAP_CLASSROOMS); i++) {
+            const SnapshotClassroom& record = classrooms[i];
+            state.classrooms.push_back(new Classroom(string(view.text(record.roomNumber)), string(view.text(record.building)),
+                                                     record.capacity, record.hasProjector != 0));
+        }
+
+        const SnapshotCourse* courses = view.records<SnapshotCourse>(SNAP_COURSES);
+        for (size_t i = 0; i < view.count(SNAP_COURSES); i++) {
+            const SnapshotCourse& record = courses[i];
+            Course* course = new Course(string(view.text(record.code)), string(view.text(record.title)),
+                                        string(view.text(record.description)), record.credits, record.maxCapacity);
+            state.courses.push_back(course);
+            course->enrollment_deadline = parseDate(view.text(record.deadline));
+            course->deadline_full_year = fourDigitYear(view.text(record.deadline));
+            course->instructor = personAt<Professor>(state.people, record.instructor);
+            if (record.waitlistCapacity > 0) course->waitlist.resize(record.waitlistCapacity);
+            course->enrolled_students.reserve(record.students.count);
+            for (uint32_t k = 0; k < record.students.count; k++) {
+                Student* student = personAt<Student>(state.people, view.index(record.students, k));
+                if (student == nullptr) throw UniversitySystemException("Snapshot roster entry is invalid", 601);
+                course->addToRosterLocked(student);
+            }
+            for (uint32_t k = 0; k < record.waitlist.count; k++) {
+                Student* waiting = personAt<Student>(state.people, view.index(record.waitlist, k));
+                if (waiting == nullptr || !course->waitlist.push(waiting)) throw UniversitySystemException("Snapshot waitlist entry is invalid", 601);
+            }
+        }
+
+        const SnapshotGradeBook* books = view.records<SnapshotGradeBook>(SNAP_GRADEBOOKS);
+        const uint32_t* gradeIDs = view.records<uint32_t>(SNAP_GRADE_IDS);
+        const uint8_t* gradeValues = view.records<uint8_t>(SNAP_GRADE_VALUES);
+        for (size_t i = 0; i < view.count(SNAP_GRADEBOOKS); i++) {
+            const SnapshotGradeBook& record = books[i];
+            view.checkRange(record.grades, min(view.count(SNAP_GRADE_IDS), view.count(SNAP_GRADE_VALUES)));
+            GradeBook* book = new GradeBook();
+            state.gradebooks.push_back(book);
+            book->courseCode = string(view.text(record.courseCode));
+            for (uint32_t k = record.grades.first; k < record.grades.first + record.grades.count; k++) {
+                if (gradeValues[k] > 100) throw UniversitySystemException("Snapshot grade out of range", 601);
+                book->storeGrade(string(view.text(gradeIDs[k])), gradeValues[k]);
+            }
+        }
+
+        if (view.getFlags() & SNAP_HAS_ENROLLMENTS) {
+            state.enrollments = new EnrollmentManager();
+            const SnapshotEnrollment* enrollments = view.records<SnapshotEnrollment>(SNAP_ENROLLMENTS);
+            for (size_t i = 0; i < view.count(SNAP_ENROLLMENTS); i++) {
+                uint64_t lsn;
+                state.enrollments->insertEnrollment(string(view.text(enrollments[i].courseCode)), string(view.text(enrollments[i].studentID)), lsn);
+            }
+        }
+
+        if (view.getFlags() & SNAP_HAS_SCHEDULE) {
+            state.schedule = new Schedule();
+            const SnapshotTimeSlot* slots = view.records<SnapshotTimeSlot>(SNAP_TIME_SLOTS);
+            state.schedule->slab.reserve(view.count(SNAP_TIME_SLOTS));
+            for (size_t i = 0; i < view.count(SNAP_TIME_SLOTS); i++) {
+                const SnapshotTimeSlot& record = slots[i];
+                Course* course = objectAt(state.courses, record.course);
+                Classroom* classroom = objectAt(state.classrooms, record.classroom);
+                if (course == nullptr || classroom == nullptr) throw UniversitySystemException("Snapshot time slot is incomplete", 601);
+                if (!state.schedule->insertTimeSlot(record.day, record.startMinute, record.endMinute, course, classroom)) {
+                    throw UniversitySystemException("Snapshot time slot is invalid or overlaps another", 601);
+                }
+            }
+        }
+    }
+public:
+    // Writes to path + ".tmp" first and renames, so a crash never leaves a
+    // half-written snapshot behind.
+    static void save(const string& path, UniversityState& state) {
+        Writer writer;
+        for (auto person : state.people) writer.addPerson(person);
+        for (auto department : state.departments) writer.addDepartment(department);
+        if (state.university != nullptr) {
+            for (auto department : state.university->departments) writer.addDepartment(department);
+        }
+        for (auto course : state.courses) writer.addCourse(course);
+        for (auto classroom : state.classrooms) writer.addClassroom(classroom);
+        if (state.schedule != nullptr) {
+            state.schedule->forEachTimeSlot([&writer](const Schedule::TimeSlot& slot) {
+                writer.addCourse(slot.course);
+                writer.addClassroom(slot.classroom);
+            });
+        }
+
+        vector<SnapshotDepartment> departments;
+        for (auto department : writer.departments) {
+            vector<uint32_t> professors;
+            for (auto professor : department->professors) professors.push_back(writer.addPerson(professor));
+            departments.push_back({writer.addString(department->getDepartmentName()), writer.addString(department->getDepartmentLocation()),
+                                   department->getDepartmentBudget(), writer.addIndices(professors)});
+        }
+
+        vector<SnapshotUniversity> university;
+        if (state.university != nullptr) {
+            vector<uint32_t> members;
+            for (auto department : state.university->departments) members.push_back(writer.departmentIndex[department]);
+            university.push_back({writer.addString(state.university->getUniversityName()),
+                                  writer.addString(state.university->getUniversityLocation()), writer.addIndices(members)});
+        }
+
+        vector<SnapshotCourse> courses;
+        for (auto course : writer.courses) {
+            SnapshotCourse record;
+            memset(&record, 0, sizeof(record));
+            record.code = writer.addString(course->getCourseCode());
+            record.title = writer.addString(course->getCourseTitle());
+            record.description = writer.addString(course->getCourseDescription());
+            record.deadline = writer.addString(course->getEnrollmentDeadline());
+            record.credits = course->getCourseCredits();
+            record.maxCapacity = course->getMaxCapacity();
+            vector<uint32_t> waiting;
+            {
+                lock_guard<mutex> guard(course->roster_lock);
+                record.waitlistCapacity = course->waitlist.capacity();
+                for (size_t k = 0; k < course->waitlist.size(); k++) waiting.push_back(writer.addPerson(course->waitlist.at(k)));
+            }
+            record.instructor = writer.addPerson(course->getCourseInstructor());
+            vector<uint32_t> students;
+            for (auto student : course->getEnrolledStudents()) students.push_back(writer.addPerson(student));
+            record.students = writer.addIndices(students);
+            record.waitlist = writer.addIndices(waiting);
+            courses.push_back(record);
+        }
+
+        vector<SnapshotClassroom> classrooms;
+        for (auto classroom : writer.classrooms) {
+            classrooms.push_back({writer.addString(classroom->getClassroomRoomNumber()), writer.addString(classroom->getClassroomBuilding()),
+                                  classroom->getClassroomCapacity(), classroom->getClassroomHasProjector() ? 1u : 0u});
+        }
+
+        vector<SnapshotGradeBook> books;
+        vector<uint32_t> gradeIDs;
+        vector<uint8_t> gradeValues;
+        for (auto book : state.gradebooks) {
+            books.push_back({writer.addString(book->courseCode), {(uint32_t)gradeIDs.size(), (uint32_t)book->grades.size()}});
+            for (auto& ID : book->studentIDs) gradeIDs.push_back(writer.addString(ID));
+            gradeValues.insert(gradeValues.end(), book->grades.begin(), book->grades.end());
+        }
+
+        vector<SnapshotEnrollment> enrollments;
+        if (state.enrollments != nullptr) {
+            state.enrollments->forEachEnrollment([&](const string& courseCode, const string& ID) {
+                enrollments.push_back({writer.addString(courseCode), writer.addString(ID)});
+            });
+        }
+
+        vector<SnapshotTimeSlot> slots;
+        if (state.schedule != nullptr) {
+            state.schedule->forEachTimeSlot([&](const Schedule::TimeSlot& slot) {
+                slots.push_back({(uint32_t)slot.day, (uint32_t)slot.start_minute, (uint32_t)slot.end_minute,
+                                 writer.courseIndex[slot.course], writer.classroomIndex[slot.classroom]});
+            });
+        }
+
+        // Encoding people can still add strings, so it runs before the string table is written.
+        vector<SnapshotPerson> people;
+        for (size_t i = 0; i < writer.people.size(); i++) people.push_back(encodePerson(writer.people[i], writer));
+
+        SnapshotHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "UNISNAP", 8);
+        header.version = SnapshotView::VERSION;
+        header.sectionCount = SNAP_SECTION_COUNT;
+        header.flags = (state.enrollments != nullptr ? SNAP_HAS_ENROLLMENTS : 0) | (state.schedule != nullptr ? SNAP_HAS_SCHEDULE : 0);
+
+        string file(sizeof(SnapshotHeader), '\0');
+        appendSection(file, header, SNAP_STRINGS, writer.strings.data(), writer.strings.size());
+        appendSection(file, header, SNAP_STRING_DATA, writer.stringData.data(), writer.stringData.size());
+        appendSection(file, header, SNAP_INDICES, writer.indices.data(), writer.indices.size());
+        appendSection(file, header, SNAP_PEOPLE, people.data(), people.size());
+        appendSection(file, header, SNAP_DEPARTMENTS, departments.data(), departments.size());
+        appendSection(file, header, SNAP_UNIVERSITY, university.data(), university.size());
+        appendSection(file, header, SNAP_COURSES, courses.data(), courses.size());
+        appendSection(file, header, SNAP_CLASSROOMS, classrooms.data(), classrooms.size());
+        appendSection(file, header, SNAP_GRADEBOOKS, books.data(), books.size());
+        appendSection(file, header, SNAP_GRADE_IDS, gradeIDs.data(), gradeIDs.size());
+        appendSection(file, header, SNAP_GRADE_VALUES, gradeValues.data(), gradeValues.size());
+        appendSection(file, header, SNAP_ENROLLMENTS, enrollments.data(), enrollments.size());
+        appendSection(file, header, SNAP_TIME_SLOTS, slots.data(), slots.size());
+        header.fileSize = file.size();
+        memcpy(&file[0], &header, sizeof(header));
+
+        string temporary = path + ".tmp";
+        ofstream out(temporary, ios::binary | ios::trunc);
+        out.write(file.data(), file.size());
+        out.close();
+        if (!out || rename(temporary.c_str(), path.c_str()) != 0) {
+            cout << "Snapshot Could not be Written!\n";
+            throw UniversitySystemException("Failed to write snapshot " + path, 600);
+        }
+        cout << "Snapshot Saved Successfully!\n";
+    }
+
+    // Fills an empty state with new objects rebuilt from the snapshot. The file
+    // is read in place through the mapped view, but every object is still
+    // allocated and filled from it. Any failure leaves state untouched and is
+    // reported as error 600.
+    static void load(const string& path, UniversityState& state) {
+        SnapshotView view;
+        if (!view.open(path)) {
+            cout << "Snapshot Missing or Corrupt!\n";
+            throw UniversitySystemException("Failed to open snapshot " + path, 600);
+        }
+        UniversityState loaded;
+        string reason;
+        try {
+            restore(view, loaded);
+        } catch (const exception& e) {
+            reason = e.what();
+        } catch (...) {
+            reason = "unknown error";
+        }
+        if (!reason.empty()) {
+            // A corrupt length can throw bad_alloc or length_error partway through.
+            loaded.release();
+            cout << "Snapshot Corrupt!\n";
+            throw UniversitySystemException("Snapshot " + path + " is corrupt: " + reason, 600);
+        }
+        state = loaded;
+        cout << "Snapshot Loaded Successfully!\n";
+    }
+};
+
+// Crash recovery: load the latest snapshot, then replay the write-ahead log on
+// top of it. Records that name a course or student missing from the snapshot
+// are skipped, since people and courses themselves are not logged.
+class UniversityRecovery {
+private:
+    static void applyCourseRecord(Course* course, Student* student, bool enroll) {
+        lock_guard<mutex> guard(course->roster_lock);
+        auto& roster = course->enrolled_students;
+        auto found = find(roster.begin(), roster.end(), student);
+        // A promotion is logged only as an enrollment, so it also leaves the queue.
+        if (enroll) course->waitlist.remove(student->getPersonID());
+        if (enroll && found == roster.end()) {
+            course->addToRosterLocked(student);
+        } else if (!enroll && found != roster.end()) {
+            course->removeFromRosterLocked(found - roster.begin());
+        }
+    }
+
+    static void applyWaitlistRecord(Course* course, Student* student, bool join) {
+        lock_guard<mutex> guard(course->roster_lock);
+        if (!join) {
+            course->waitlist.remove(student->getPersonID());
+        } else if (!course->isEnrolledLocked(student->getPersonID())) {
+            course->waitlist.push(student);
+        }
+    }
+public:
+    static void recover(const string& snapshotPath, const string& walPath, UniversityState& state) {
+        if (access(snapshotPath.c_str(), F_OK) == 0) {
+            UniversitySnapshot::load(snapshotPath, state);
+        }
+
+        // The first person or course loaded under a key keeps it.
+        OpenHashMap<int, Person*> people;
+        OpenHashMap<uint32_t, Course*> courses;
+        people.reserve(state.people.size());
+        courses.reserve(state.courses.size());
+        for (auto person : state.people) if (person != nullptr) people.insert(person->getPersonID(), person);
+        for (auto course : state.courses) if (course != nullptr) courses.insert(course->getCourseCodeSymbol(), course);
+        unordered_map<string, GradeBook*> books;
+        for (auto book : state.gradebooks) books[book->courseCode] = book;
+
+        size_t skipped = 0;
+        bool tornTail;
+        size_t replayed = WriteAheadLog::replay(walPath, [&](WriteAheadLog::RecordType type, const string& courseCode, const string& ID, int value) {
+            uint64_t lsn;
+            switch (type) {
+                case WriteAheadLog::COURSE_ENROLL:
+                case WriteAheadLog::COURSE_DROP:
+                case WriteAheadLog::WAITLIST_JOIN:
+                case WriteAheadLog::WAITLIST_LEAVE: {
+                    int studentID = 0;
+                    auto parsed = from_chars(ID.data(), ID.data() + ID.size(), studentID);
+                    uint32_t symbol;
+                    Course** course_entry = symbols().lookup(courseCode, symbol) ? courses.find(symbol) : nullptr;
+                    Person** person_entry = parsed.ec == errc() && parsed.ptr == ID.data() + ID.size() ? people.find(studentID) : nullptr;
+                    Course* course = course_entry != nullptr ? *course_entry : nullptr;
+                    Student* student = person_entry != nullptr ? dynamic_cast<Student*>(*person_entry) : nullptr;
+                    if (course == nullptr || student == nullptr) {
+                        skipped++;
+                        return;
+                    }
+                    if (type == WriteAheadLog::COURSE_ENROLL || type == WriteAheadLog::COURSE_DROP) {
+                        applyCourseRecord(course, student, type == WriteAheadLog::COURSE_ENROLL);
+                    } else {
+                        applyWaitlistRecord(course, student, type == WriteAheadLog::WAITLIST_JOIN);
+                    }
+                    break;
+                }
+                case WriteAheadLog::MANAGER_ENROLL:
+                case WriteAheadLog::MANAGER_DROP:
+                    if (state.enrollments == nullptr) state.enrollments = new EnrollmentManager();
+                    if (type == WriteAheadLog::MANAGER_ENROLL) {
+                        state.enrollments->insertEnrollment(courseCode, ID, lsn);
+                    } else {
+                        state.enrollments->removeEnrollment(courseCode, ID, lsn);
+                    }
+                    break;
+                case WriteAheadLog::GRADE: {
+                    if (value < 0 || value > 100) {
+                        skipped++;
+                        return;
+                    }
+                    GradeBook*& book = books[courseCode];
+                    if (book == nullptr) {
+                        book = new GradeBook(courseCode);
+                        state.gradebooks.push_back(book);
+                    }
+                    book->storeGrade(ID, value);
+                    break;
+                }
+                default:
+                    skipped++;
+            }
+        }, tornTail);
+
+        cout << "Recovered " << replayed << " Log Records (" << skipped << " Skipped)" << (tornTail ? ", Torn Tail Discarded" : "") << "\n";
+    }
+
+    // Saves a snapshot and empties the log. Writers must be paused meanwhile,
+    // or changes logged between the two steps are lost.
+    static void checkpoint(const string& snapshotPath, WriteAheadLog& wal, UniversityState& state) {
+        UniversitySnapshot::save(snapshotPath, state);
+        wal.reset();
+    }
+};
+
+// Checks whole columns of person IDs (5 digits) and contact numbers (10
+// digits) with range compares, eight rows at a time on AVX2 and one at a time
+// otherwise. The ranges are validPersonID and validContactNumber's rule.
+class PersonFieldValidator {
+private:
+    static constexpr long long ID_LOW = POWERS_OF_TEN[4], ID_HIGH = POWERS_OF_TEN[5] - 1;
+    static constexpr long long CONTACT_LOW = POWERS_OF_TEN[9], CONTACT_HIGH = POWERS_OF_TEN[10] - 1;
+
+#ifdef UNIVERSITY_HAVE_AVX2
+    static bool hasAVX2() {
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+    }
+
+    __attribute__((target("avx2")))
+    static size_t invalidRowsAVX2(const int* IDs, const long long* contacts, size_t n, vector<uint32_t>& rows) {
+        const __m256i id_low = _mm256_set1_epi32(ID_LOW - 1), id_high = _mm256_set1_epi32(ID_HIGH + 1);
+        const __m256i contact_low = _mm256_set1_epi64x(CONTACT_LOW - 1), contact_high = _mm256_set1_epi64x(CONTACT_HIGH + 1);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256i ids = _mm256_loadu_si256((const __m256i*)(IDs + i));
+            __m256i first = _mm256_loadu_si256((const __m256i*)(contacts + i));
+            __m256i second = _mm256_loadu_si256((const __m256i*)(contacts + i + 4));
+            __m256i id_ok = _mm256_and_si256(_mm256_cmpgt_epi32(ids, id_low), _mm256_cmpgt_epi32(id_high, ids));
+            __m256i first_ok = _mm256_and_si256(_mm256_cmpgt_epi64(first, contact_low), _mm256_cmpgt_epi64(contact_high, first));
+            __m256i second_ok = _mm256_and_si256(_mm256_cmpgt_epi64(second, contact_low), _mm256_cmpgt_epi64(contact_high, second));
+            uint32_t ok = _mm256_movemask_ps(_mm256_castsi256_ps(id_ok))
+                        & (_mm256_movemask_pd(_mm256_castsi256_pd(first_ok)) | _mm256_movemask_pd(_mm256_castsi256_pd(second_ok)) << 4);
+            uint32_t bad = ~ok & 0xFF;
+            while (bad != 0) {
+                rows.push_back(i + __builtin_ctz(bad));
+                bad &= bad - 1;
+            }
+        }
+        return i;
+    }
+#endif
+public:
+    static bool validID(long long ID) {
+        return validPersonID(ID);
+    }
+
+    static bool validContact(long long contact) {
+        return validContactNumber(contact);
+    }
+
+    // Why a row fails, checking the ID first; nullptr when it passes.
+    static const char* reason(long long ID, long long contact) {
+        if (!validID(ID)) return "ID must be 5 digits";
+        if (!validContact(contact)) return "Contact number must be 10 digits";
+        return nullptr;
+    }
+
+    // Indices of rows whose ID or contact number is out of range, ascending.
+    static vector<uint32_t> invalidRows(const int* IDs, const long long* contacts, size_t n) {
+        vector<uint32_t> rows;
+        size_t i = 0;
+#ifdef UNIVERSITY_HAVE_AVX2
+        if (hasAVX2()) i = invalidRowsAVX2(IDs, contacts, n, rows);
+#endif
+        for (; i < n; i++) {
+            if (!validID(IDs[i]) || !validContact(contacts[i])) rows.push_back(i);
+        }
+        return rows;
+    }
+};
+
+// Loads people, courses and grades from CSV files (TSV when the file name ends
+// in .tsv). The file is mapped and split into chunks on line boundaries; each
+// thread tokenizes and validates its chunk in place without copying fields.
+// Valid rows are then constructed straight into per-type blocks sized from the
+// row counts. Imported people and courses belong to the importer and live
+// until it is destroyed. Lines starting with '#' and the header line are skipped.
+//
+//   people:  kind,name,age,id,contact,<kind fields>
+//            student        enrollment_date,program,gpa
+//            undergraduate  enrollment_date,program,gpa,major,minor,graduation_date
+//            graduate       enrollment_date,program,gpa,research_topic,thesis_title
+//            professor      department,hire_date,specialization
+//            assistant_professor  ...,contract_years,papers_published,promotion_eligible
+//            associate_professor  ...,teaching_years,projects_done,students_guided
+//            full_professor       ...,work_years,foreign_papers,is_head
+//   courses: code,title,description,credits,max_capacity[,enrollment_deadline]
+//   grades:  course_code,student_id,grade
+class BulkImporter {
+public:
+    struct ImportError {
+        size_t line;
+        const char* reason;
+    };
+
+    struct Report {
+        size_t rows = 0;
+        size_t imported = 0;
+        vector<ImportError> errors;
+        double seconds = 0;
+
+        void display() {
+            cout << "Imported " << imported << " of " << rows << " Rows in " << seconds * 1000 << " ms\n";
+            for (size_t i = 0; i < errors.size() && i < 10; i++) {
+                cout << "Line " << errors[i].line << ": " << errors[i].reason << "\n";
+            }
+            if (errors.size() > 10) cout << "... and " << errors.size() - 10 << " more errors\n";
+        }
+    };
+private:
+    static const size_t MAX_FIELDS = 12;
+
+    struct Block {
+        void* memory;
+        size_t count;
+        void (*destroy)(void*, size_t);
+    };
+    vector<Block> blocks;
+
+    struct Chunk {
+        const char* begin;
+        const char* end;
+        size_t lines = 0;
+        vector<ImportError> errors;
+    };
+
+    struct PersonRow {
+        PersonKind kind;
+        string_view name;
+        string_view text[5];
+        int age, ID;
+        long long contact;
+        int numbers[3];
+        double gpa;
+        bool flag;
+    };
+
+    struct CourseRow {
+        string_view code, title, description, deadline;
+        double credits;
+        int capacity;
+    };
+
+    struct GradeRow {
+        string_view courseCode, ID;
+        int grade;
+    };
+
+    template <typename T>
+    T* allocate(size_t count) {
+        if (count == 0) return nullptr;
+        T* memory = (T*)::operator new(count * sizeof(T));
+        blocks.push_back({memory, count, [](void* items, size_t n) {
+            for (size_t i = 0; i < n; i++) ((T*)items)[i].~T();
+            ::operator delete(items);
+        }});
+        return memory;
+    }
+
+    static size_t splitFields(string_view line, char delimiter, string_view* fields) {
+        size_t count = 0;
+        while (count < MAX_FIELDS) {
+            size_t end = line.find(delimiter);
+            fields[count++] = line.substr(0, end);
+            if (end == string_view::npos) break;
+            line.remove_prefix(end + 1);
+        }
+        return count;
+    }
+
+    template <typename T>
+    static bool parseNumber(string_view text, T& value) {
+        auto result = from_chars(text.data(), text.data() + text.size(), value);
+        return result.ec == errc() && result.ptr == text.data() + text.size();
+    }
+
+    static bool validDate(string_view text) {
+        return parseDate(text) != 0;
+    }
+
+    // Cuts the mapped file into about one chunk per thread, always on a line end,
+    // after skipping the header line.
+    static vector<Chunk> splitChunks(const char* data, size_t size, unsigned threads) {
+        const char* start = data;
+        const char* end = data + size;
+        const char* header = (const char*)memchr(start, '\n', size);
+        start = header == nullptr ? end : header + 1;
+
+        vector<Chunk> chunks;
+        size_t target = max<size_t>((end - start) / threads, 1);
+        while (start < end) {
+            const char* cut = start + min<size_t>(target, end - start);
+            if (cut < end) {
+                const char* newline = (const char*)memchr(cut, '\n', end - cut);
+                cut = newline == nullptr ? end : newline + 1;
+            }
+            Chunk chunk;
+            chunk.begin = start;
+            chunk.end = cut;
+            chunks.push_back(chunk);
+            start = cut;
+        }
+        return chunks;
+    }
+
+    // Runs parse(chunk index, line, fields, field count) over every data line,
+    // one thread per chunk. parse returns an error message or nullptr.
+    template <typename Parser>
+    static void parseChunks(vector<Chunk>& chunks, char delimiter, Parser parse) {
+        auto work = [&](size_t index) {
+            Chunk& chunk = chunks[index];
+            string_view fields[MAX_FIELDS];
+            const char* at = chunk.begin;
+            while (at < chunk.end) {
+                const char* newline = (const char*)memchr(at, '\n', chunk.end - at);
+                const char* lineEnd = newline == nullptr ? chunk.end : newline;
+                string_view line(at, lineEnd - at);
+                at = lineEnd + 1;
+                chunk.lines++;
+                if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+                if (line.empty() || line[0] == '#') continue;
+                const char* error = parse(index, splitFields(line, delimiter, fields), fields);
+                if (error != nullptr) chunk.errors.push_back({chunk.lines, error});
+            }
+        };
+        vector<thread> workers;
+        for (size_t i = 1; i < chunks.size(); i++) workers.emplace_back(work, i);
+        if (!chunks.empty()) work(0);
+        for (auto& worker : workers) worker.join();
+    }
+
+    // Turns chunk-local error lines into file line numbers (the header is line 1).
+    static void collectErrors(vector<Chunk>& chunks, Report& report) {
+        size_t line = 1;
+        for (auto& chunk : chunks) {
+            for (auto& error : chunk.errors) report.errors.push_back({line + error.line, error.reason});
+            line += chunk.lines;
+        }
+    }
+
+    static char delimiterFor(const string& path) {
+        return path.size() >= 4 && path.compare(path.size() - 4, 4, ".tsv") == 0 ? '\t' : ',';
+    }
+
+    static unsigned threadCount(unsigned threads) {
+        return threads == 0 ? max(1u, thread::hardware_concurrency()) : threads;
+    }
+
+    static const char* parsePerson(size_t count, string_view* fields, PersonRow& row) {
+        static const char* names[PERSON_KIND_COUNT] = {"person", "student", "undergraduate", "graduate", "professor",
+                                                       "assistant_professor", "associate_professor", "full_professor"};
+        static const size_t fieldCounts[PERSON_KIND_COUNT] = {5, 8, 11, 10, 8, 11, 11, 11};
+        int kind = 0;
+        while (kind < PERSON_KIND_COUNT && fields[0] != names[kind]) kind++;
+        if (kind == PERSON_KIND_COUNT) return "Unknown person kind";
+        if (count != fieldCounts[kind]) return "Wrong number of fields";
+        row.kind = (PersonKind)kind;
+        row.name = fields[1];
+        if (row.name.empty()) return "Name cannot be empty";
+        if (!parseNumber(fields[2], row.age) || row.age < 0 || row.age > 100) return "Age must be between 0 and 100";
+        if (!parseNumber(fields[3], row.ID)) return "ID must be 5 digits";
+        if (!parseNumber(fields[4], row.contact)) return "Contact number must be 10 digits";
+        // Digit counts of rows that parse are checked a column at a time later;
+        // a row failing both a later field and its digit count reports the latter.
+        const char* error = parsePersonFields(kind, fields, row);
+        if (error != nullptr && PersonFieldValidator::reason(row.ID, row.contact) != nullptr) return PersonFieldValidator::reason(row.ID, row.contact);
+        return error;
+    }
+
+    static const char* parsePersonFields(int kind, string_view* fields, PersonRow& row) {
+        if (kind == KIND_STUDENT || kind == KIND_UNDERGRADUATE || kind == KIND_GRADUATE) {
+            row.text[0] = fields[5];
+            row.text[1] = fields[6];
+            if (!validDate(fields[5])) return "Invalid enrollment date";
+            if (fields[6].empty()) return "Program cannot be empty";
+            if (!parseNumber(fields[7], row.gpa) || row.gpa < 0 || row.gpa > 4) return "GPA must be between 0 and 4";
+            if (kind == KIND_UNDERGRADUATE) {
+                row.text[2] = fields[8];
+                row.text[3] = fields[9];
+                row.text[4] = fields[10];
+                if (fields[8].empty() || fields[9].empty()) return "Major and minor cannot be empty";
+                if (!validDate(fields[10])) return "Invalid graduation date";
+            } else if (kind == KIND_GRADUATE) {
+                row.text[2] = fields[8];
+                row.text[3] = fields[9];
+            }
+        } else if (kind >= KIND_PROFESSOR) {
+            for (int i = 0; i < 3; i++) row.text[i] = fields[5 + i];
+            if (fields[5].empty()) return "Department cannot be empty";
+            if (!validDate(fields[6])) return "Invalid hire date";
+            if (fields[7].empty()) return "Specialization cannot be empty";
+            if (kind != KIND_PROFESSOR) {
+                for (int i = 0; i < 3; i++) {
+                    if (!parseNumber(fields[8 + i], row.numbers[i]) || row.numbers[i] < 0) return "Counts cannot be negative";
+                }
+                row.flag = row.numbers[2] != 0;
+            }
+        }
+        return nullptr;
+    }
+
+    void constructPerson(void* slot, const PersonRow& row) {
+        auto text = [&row](int i) { return string(row.text[i]); };
+        Person* person = nullptr;
+        switch (row.kind) {
+            case KIND_PERSON: person = new (slot) Person(); break;
+            case KIND_STUDENT: person = new (slot) Student(text(0), text(1), row.gpa); break;
+            case KIND_UNDERGRADUATE: person = new (slot) UndergraduateStudent(text(0), text(1), row.gpa, text(2), text(3), text(4)); break;
+            case KIND_GRADUATE: person = new (slot) GraduateStudent(text(0), text(1), row.gpa, text(2), text(3)); break;
+            case KIND_PROFESSOR: person = new (slot) Professor(text(0), text(1), text(2)); break;
+            case KIND_ASSISTANT_PROFESSOR: person = new (slot) AssistantProfessor(text(0), text(1), text(2), row.numbers[0], row.numbers[1], row.flag); break;
+            case KIND_ASSOCIATE_PROFESSOR: person = new (slot) AssociateProfessor(text(0), text(1), text(2), row.numbers[0], row.numbers[1], row.numbers[2]); break;
+            case KIND_FULL_PROFESSOR: person = new (slot) FullProfessor(text(0), text(1), text(2), row.numbers[0], row.numbers[1], row.flag); break;
+            default: return;
+        }
+        person->name.assign(row.name.data(), row.name.size());
+        person->ageID = row.age;
+        person->ID = row.ID;
+        person->contact_info = row.contact;
+    }
+public:
+    BulkImporter() {}
+    BulkImporter(const BulkImporter&) = delete;
+    BulkImporter& operator=(const BulkImporter&) = delete;
+    ~BulkImporter() {
+        for (auto& block : blocks) block.destroy(block.memory, block.count);
+    }
+
+    Report importPeople(const string& path, vector<Person*>& people, unsigned threads = 0) {
+        Report report;
+        auto start = chrono::steady_clock::now();
+        MappedFile file;
+        if (!file.open(path)) {
+            cout << "Import File " << path << " Could not be Opened!\n";
+            throw UniversitySystemException("Failed to open import file " + path, 700);
+        }
+        vector<Chunk> chunks = splitChunks(file.data(), file.size(), threadCount(threads));
+        vector<vector<PersonRow>> rows(chunks.size());
+        vector<vector<int>> IDs(chunks.size());
+        vector<vector<long long>> contacts(chunks.size());
+        vector<vector<size_t>> lines(chunks.size());
+        vector<size_t> attempted(chunks.size(), 0);
+        parseChunks(chunks, delimiterFor(path), [&](size_t chunk, size_t count, string_view* fields) -> const char* {
+            attempted[chunk]++;
+            PersonRow row;
+            const char* error = parsePerson(count, fields, row);
+            if (error == nullptr) {
+                rows[chunk].push_back(row);
+                IDs[chunk].push_back(row.ID);
+                contacts[chunk].push_back(row.contact);
+                lines[chunk].push_back(chunks[chunk].lines);
+            }
+            return error;
+        });
+        for (size_t c = 0; c < chunks.size(); c++) {
+            vector<uint32_t> invalid = PersonFieldValidator::invalidRows(IDs[c].data(), contacts[c].data(), IDs[c].size());
+            if (invalid.empty()) continue;
+            size_t kept = 0, next = 0;
+            for (size_t i = 0; i < rows[c].size(); i++) {
+                if (next < invalid.size() && invalid[next] == i) {
+                    chunks[c].errors.push_back({lines[c][i], PersonFieldValidator::reason(rows[c][i].ID, rows[c][i].contact)});
+                    next++;
+                } else {
+                    rows[c][kept++] = rows[c][i];
+                }
+            }
+            rows[c].resize(kept);
+            stable_sort(chunks[c].errors.begin(), chunks[c].errors.end(), [](const ImportError& a, const ImportError& b) { return a.line < b.line; });
+        }
+        collectErrors(chunks, report);
+
+        // One block per kind, sized exactly; each chunk then fills its own slots.
+        vector<array<size_t, PERSON_KIND_COUNT>> offsets(chunks.size());
+        array<size_t, PERSON_KIND_COUNT> totals = {};
+        for (size_t c = 0; c < chunks.size(); c++) {
+            report.rows += attempted[c];
+            offsets[c] = totals;
+            for (auto& row : rows[c]) totals[row.kind]++;
         }
-        return allProfessors;
+        char* bases[PERSON_KIND_COUNT] = {
+            (char*)allocate<Person>(totals[KIND_PERSON]), (char*)allocate<Student>(totals[KIND_STUDENT]),
+            (char*)allocate<UndergraduateStudent>(totals[KIND_UNDERGRADUATE]), (char*)allocate<GraduateStudent>(totals[KIND_GRADUATE]),
+            (char*)allocate<Professor>(totals[KIND_PROFESSOR]), (char*)allocate<AssistantProfessor>(totals[KIND_ASSISTANT_PROFESSOR]),
+            (char*)allocate<AssociateProfessor>(totals[KIND_ASSOCIATE_PROFESSOR]), (char*)allocate<FullProfessor>(totals[KIND_FULL_PROFESSOR])};
+        const size_t sizes[PERSON_KIND_COUNT] = {sizeof(Person), sizeof(Student), sizeof(UndergraduateStudent), sizeof(GraduateStudent),
+                                                 sizeof(Professor), sizeof(AssistantProfessor), sizeof(AssociateProfessor), sizeof(FullProfessor)};
+
+        size_t first = people.size();
+        vector<size_t> outputStart(chunks.size());
+        for (size_t c = 0; c < chunks.size(); c++) {
+            outputStart[c] = first + report.imported;
+            report.imported += rows[c].size();
+        }
+        people.resize(first + report.imported);
+        vector<thread> workers;
+        for (size_t c = 0; c < chunks.size(); c++) {
+            workers.emplace_back([&, c]() {
+                array<size_t, PERSON_KIND_COUNT> next = offsets[c];
+                for (size_t i = 0; i < rows[c].size(); i++) {
+                    const PersonRow& row = rows[c][i];
+                    char* slot = bases[row.kind] + next[row.kind]++ * sizes[row.kind];
+                    constructPerson(slot, row);
+                    people[outputStart[c] + i] = (Person*)(void*)slot;
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+
+        report.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return report;
     }
-    
-    void displayDepartments() {
-        if (departments.empty()) {
-            cout << "No Departments in University!\n";
-            return;
+
+    Report importCourses(const string& path, vector<Course*>& courses, unsigned threads = 0) {
+        Report report;
+        auto start = chrono::steady_clock::now();
+        MappedFile file;
+        if (!file.open(path)) {
+            cout << "Import File " << path << " Could not be Opened!\n";
+            throw UniversitySystemException("Failed to open import file " + path, 700);
         }
-        cout << "Departments in " << name << ":\n";
-        for (auto dept : departments) {
-            cout << "Name: " << dept->getDepartmentName() << ", Location: " << dept->getDepartmentLocation() << "\n";
+        vector<Chunk> chunks = splitChunks(file.data(), file.size(), threadCount(threads));
+        vector<vector<CourseRow>> rows(chunks.size());
+        vector<size_t> attempted(chunks.size(), 0);
+        parseChunks(chunks, delimiterFor(path), [&](size_t chunk, size_t count, string_view* fields) -> const char* {
+            attempted[chunk]++;
+            if (count != 5 && count != 6) return "Wrong number of fields";
+            CourseRow row;
+            row.code = fields[0];
+            row.title = fields[1];
+            row.description = fields[2];
+            row.deadline = count == 6 ? fields[5] : string_view();
+            if (row.code.empty() || row.title.empty()) return "Course code and title cannot be empty";
+            if (!parseNumber(fields[3], row.credits) || row.credits <= 0) return "Credits must be positive";
+            if (!parseNumber(fields[4], row.capacity) || row.capacity <= 0) return "Capacity must be positive";
+            if (!row.deadline.empty() && !validDate(row.deadline)) return "Invalid enrollment deadline";
+            rows[chunk].push_back(row);
+            return nullptr;
+        });
+        collectErrors(chunks, report);
+
+        for (size_t c = 0; c < chunks.size(); c++) {
+            report.rows += attempted[c];
+            report.imported += rows[c].size();
         }
+        Course* block = allocate<Course>(report.imported);
+        size_t next = 0;
+        for (auto& chunkRows : rows) {
+            for (auto& row : chunkRows) {
+                Course* course = new (block + next++) Course(string(row.code), string(row.title), string(row.description), row.credits, row.capacity);
+                if (!row.deadline.empty()) {
+                    course->enrollment_deadline = parseDate(row.deadline);
+                    course->deadline_full_year = fourDigitYear(row.deadline);
+                }
+                courses.push_back(course);
+            }
+        }
+
+        report.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return report;
     }
-    
-    void displayAllProfessors() {
-        vector<Professor*> allProfessors = getAllProfessors();
-        if (allProfessors.empty()) {
-            cout << "No Professors in University!\n";
-            return;
+
+    // Adds grades to the book with the matching course code, creating books
+    // (owned by the caller) for codes not in books yet.
+    Report importGrades(const string& path, vector<GradeBook*>& books, unsigned threads = 0) {
+        Report report;
+        auto start = chrono::steady_clock::now();
+        MappedFile file;
+        if (!file.open(path)) {
+            cout << "Import File " << path << " Could not be Opened!\n";
+            throw UniversitySystemException("Failed to open import file " + path, 700);
         }
-        cout << "All Professors in " << name << ":\n";
-        for (auto prof : allProfessors) {
-            cout << "ID: " << prof->getPersonID() << ", Name: " << prof->getPersonName() << ", Department: " << prof->getProfessorDepartment() << "\n";
+        vector<Chunk> chunks = splitChunks(file.data(), file.size(), threadCount(threads));
+        vector<vector<GradeRow>> rows(chunks.size());
+        vector<size_t> attempted(chunks.size(), 0);
+        parseChunks(chunks, delimiterFor(path), [&](size_t chunk, size_t count, string_view* fields) -> const char* {
+            attempted[chunk]++;
+            if (count != 3) return "Wrong number of fields";
+            GradeRow row;
+            row.courseCode = fields[0];
+            row.ID = fields[1];
+            if (row.courseCode.empty() || row.ID.empty()) return "Course code and student ID cannot be empty";
+            if (!parseNumber(fields[2], row.grade) || row.grade < 0 || row.grade > 100) return "Grade must be between 0 and 100";
+            rows[chunk].push_back(row);
+            return nullptr;
+        });
+        collectErrors(chunks, report);
+
+        unordered_map<string_view, GradeBook*> byCode;
+        for (auto book : books) byCode.emplace(book->courseCode, book);
+        GradeBook* last = nullptr;
+        for (size_t c = 0; c < chunks.size(); c++) {
+            report.rows += attempted[c];
+            for (auto& row : rows[c]) {
+                if (last == nullptr || last->courseCode != row.courseCode) {
+                    GradeBook*& book = byCode[row.courseCode];
+                    if (book == nullptr) {
+                        book = new GradeBook(string(row.courseCode));
+                        books.push_back(book);
+                    }
+                    last = book;
+                }
+                last->storeGrade(string(row.ID), row.grade);
+                report.imported++;
+            }
         }
+
+        report.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return report;
     }
 };
 
-class Classroom {
-private:
-    string room_number = "";
-    string building = "";
-    int capacity = 0;
-    bool has_projector = false;
-public:
-    Classroom() {}
-    Classroom(string room_number, string building, int capacity, bool has_projector) {
-        this->room_number = room_number;
-        this->building = building;
-        this->capacity = capacity;
-        this->has_projector = has_projector;
+
+
+
+
+
+
+int main(int argc, char* argv[]){
+    if (argc > 1 && string(argv[1]) == "test") {
+        errorLogPath() = "university_test_error.log";
+        testWriteAheadLog();
+        testWaitlist();
+        testObjectPool();
+        testGradeBook();
+        testPersonAssignment();
+        testPersonFieldValidator();
+        testSnapshot();
+        testScheduleConflicts();
+        testTimetable();
+        remove(errorLogPath().c_str());
+        return reportChecks();
     }
+    if (argc > 1 && string(argv[1]) == "bench") {
+        // Rejected enrollments are logged; keep them out of the real error log.
+        errorLogPath() = "university_benchmark_error.log";
+#ifndef UNIVERSITY_COUNT_ALLOCATIONS
+        cout << "Heap allocations are not counted in this build. To count them, build with:\n  " << COUNTING_BUILD << "\n";
+#endif
+        benchmarkConcurrentEnrollment();
+        benchmarkGradeAnalytics();
+        benchmarkSnapshot();
+        benchmarkWriteAheadLog();
+        benchmarkBulkImport();
+        benchmarkTimetable();
+        benchmarkPayroll();
+        benchmarkPersonPool();
+        benchmarkPersonStore();
+        benchmarkIndexes();
+        benchmarkSymbols();
+        benchmarkAllocations();
+        benchmarkErrorPath();
+        benchmarkDigitValidation();
+        remove(errorLogPath().c_str());
+        return 0;
+    }
+
+    Person person1; Person person2;
+    person1.setPersonAge(10); person2.setPersonContactInfo(9817256938);
+
+
+    Student Student1; Student Student2;
+    Student1.getPersonAgeID();  Student2.setPersonAge(20);
+
+
+    Professor pr1; Professor pr2;
+    pr1.setPersonName("Aj"); pr2.setPersonAge(99);
+
+    Course c1; Course c2;
+    c1.setCourseCode("MAL151"); c2.setCourseTitle("Very Bad course T_T");
+
+
+    Department d1; Department d2;
+    d1.setDepartmentBudget(1001); d2.setDepartmentLocation("Bahadurgarh");
+
+
+    // Part C, point 5
+    vector<Person*> people;
+    PersonPool pool;
     
-    string getClassroomRoomNumber() { return room_number; }
-    string getClassroomBuilding() { return building; }
-    int getClassroomCapacity() { return capacity; }
-    bool getClassroomHasProjector() { return has_projector; }
+
+    Student* s1 = pool.create<Student>("15/09/2024", "Computer Science", 3.8);
+    s1->setPersonName("Kanan");
+    s1->setPersonID(12345);
+    s1->setPersonAge(18);
+    s1->setPersonContactInfo(9817256938);
     
-    void setClassroomRoomNumber(string room_number) {
-        if (!room_number.empty()) {
-            this->room_number = room_number;
-            cout << "Classroom Room Number Updated Successfully!\n";
-        } else {
-            cout << "Room Number Cannot be Empty!\nRoom Number not Updated!\n";
+    Student* s2 = pool.create<Student>("15/02/2023", "Physics", 3.5);
+    s2->setPersonName("Aditi");
+    s2->setPersonID(54321);
+    s2->setPersonAge(16);
+    s2->setPersonContactInfo(1234567890);
+    
+
+    Professor* p1 = pool.create<Professor>("Computer Science", "01/06/2020", "Machine Learning");
+    p1->setPersonName("Richa Singh");
+    p1->setPersonID(98765);
+    p1->setPersonAge(22);
+    p1->setPersonContactInfo(5555555555);
+    
+    Professor* p2 = pool.create<Professor>("Mathematics", "15/07/2018", "Stats");
+    p2->setPersonName("Rajni Mam");
+    p2->setPersonID(56789);
+    p2->setPersonAge(99);
+    p2->setPersonContactInfo(6666666666);
+    
+
+    people.push_back(s1);
+    people.push_back(p1);
+    people.push_back(s2);
+    people.push_back(p2);
+    
+    cout << "\n------ Polymorphism Behaviour Yayyyyy ------\n";
+    for (auto person : people) {
+        testPerson(person);
+        cout << "--------------------------------------------------\n";
+    }
+    
+    pool.clear();
+
+    testAssistantFunctionality();
+    return 0;
+}
+
+
+//Functions
+bool dateValidator(string &date){
+    return parseDate(date) != 0;
+}
+
+// What payroll pays a person, with no penalty or bonus.
+double payrollAmount(Person* person){
+    return person->calculatePayment();
+}
+
+// Only students have a GPA column value.
+double storeGPA(Person* person){
+    if (Student* student = dynamic_cast<Student*>(person)) return student->getStudentGPA();
+    return NAN;
+}
+
+// Professors are paid from their department and students from their program.
+uint32_t payrollDepartment(Person* person){
+    if (Student* student = dynamic_cast<Student*>(person)) return student->getStudentProgramSymbol();
+    if (Professor* professor = dynamic_cast<Professor*>(person)) return professor->getProfessorDepartmentSymbol();
+    return 0;
+}
+
+inline int daysInMonth(int month, int year){
+    static const int days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == 2 && leap ? 29 : days[month - 1];
+}
+
+// Reads D/M/YY or DD/MM/YYYY (one or two digit day and month, two digit years
+// meaning 20YY) without allocating. Returns 0 for anything that is not a real date.
+uint32_t parseDate(string_view date){
+    const char* at = date.data();
+    const char* end = at + date.size();
+    int parts[3];
+    int digits[3];
+    for (int i = 0; i < 3; i++){
+        int value = 0, count = 0;
+        while (at < end && (unsigned)(*at - '0') < 10 && count < 4){
+            value = value * 10 + (*at++ - '0');
+            count++;
+        }
+        parts[i] = value;
+        digits[i] = count;
+        if (i < 2){
+            if (at == end || *at != '/') return 0;
+            at++;
         }
     }
+    if (at != end) return 0;
+    if (digits[0] < 1 || digits[0] > 2 || digits[1] < 1 || digits[1] > 2) return 0;
+    if (digits[2] != 2 && digits[2] != 4) return 0;
+
+    int day = parts[0], month = parts[1];
+    int year = digits[2] == 2 ? 2000 + parts[2] : parts[2];
+    if (month < 1 || month > 12 || year < 1) return 0;
+    if (day < 1 || day > daysInMonth(month, year)) return 0;
+    return packDate(day, month, year);
+}
+
+// Back to DD/MM/YY, or DD/MM/YYYY if asked for or the year is outside 2000-2099.
+string formatDate(uint32_t date, bool four_digit_year){
+    if (date == 0) return "";
+    int day = date & 31, month = date >> 5 & 15, year = date >> 9;
+    char text[16];
+    if (!four_digit_year && year >= 2000 && year <= 2099) snprintf(text, sizeof(text), "%02d/%02d/%02d", day, month, year - 2000);
+    else snprintf(text, sizeof(text), "%02d/%02d/%04d", day, month, year);
+    return text;
+}
+
+// Parses a column of dates into out; returns how many were valid.
+size_t parseDates(const string_view* dates, size_t count, uint32_t* out){
+    size_t valid = 0;
+    for (size_t i = 0; i < count; i++){
+        out[i] = parseDate(dates[i]);
+        valid += out[i] != 0;
+    }
+    return valid;
+}
+
+void testPerson(Person* person){
+    person->displayDetails();
+    cout << "Person's Payment: " << person->calculatePayment() << endl;
+}
+
+void testAssistantFunctionality(){
+    PersonPool pool;
+    GraduateStudent* gradStudent = pool.create<GraduateStudent>("10/01/2023", "Computer Science PhD", 3.9, "Machine Learning", "Neural Networks for Image Recognition");
+    gradStudent->setPersonName("Kanan");
+    gradStudent->setPersonID(12345);
+    gradStudent->setPersonAge(18);
+    gradStudent->setPersonContactInfo(9876543210);
     
-    void setClassroomBuilding(string building) {
-        if (!building.empty()) {
-            this->building = building;
-            cout << "Classroom Building Updated Successfully!\n";
-        } else {
-            cout << "Building Cannot be Empty!\nBuilding not Updated!\n";
+    Professor* prof = pool.create<FullProfessor>("Computer Science", "01/01/2010", "Artificial Intelligence", 15, 30, true);
+    prof->setPersonName("Richa Singh");
+    prof->setPersonID(54321);
+    
+    gradStudent->setGraduateStudentAdvisor(prof);
+    gradStudent->assignTeachingAssistantship(10000, 20);
+    gradStudent->assignResearchAssistantship(15000, 30);
+    
+    cout << "\n------ Graduate Student with Assistantships ------\n";
+    gradStudent->displayDetails();
+    cout << "Total Payment: " << gradStudent->calculatePayment() << endl;
+    
+    gradStudent->removeTeachingAssistantship();
+    cout << "\n------ After Removing Teaching Assistantship ------\n";
+    gradStudent->displayDetails();
+    cout << "Total Payment: " << gradStudent->calculatePayment() << endl;
+}
+
+// Discards console output while in scope; the setters print a line per call
+// while a benchmark builds its data.
+class QuietConsole {
+private:
+    streambuf* console;
+public:
+    QuietConsole() : console(cout.rdbuf(nullptr)) {}
+    ~QuietConsole() {
+        cout.rdbuf(console);
+        cout.clear();
+    }
+    QuietConsole(const QuietConsole&) = delete;
+    QuietConsole& operator=(const QuietConsole&) = delete;
+};
+
+// Wall-clock seconds for one call of work.
+template <typename Work>
+double secondsFor(Work work){
+    auto start = chrono::steady_clock::now();
+    work();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void benchmarkTitle(const string& name){
+    cout << "\n------ " << name << " Benchmark ------\n";
+}
+
+// Every thread keeps retrying its students on the same few courses, so most
+// attempts are duplicates or hit a full course and queue. They go through
+// tryEnrollStudent, which reports outcomes without throwing or logging, so the
+// time is the roster lock and index lookups rather than error formatting.
+void benchmarkConcurrentEnrollment(){
+    const int THREADS = max(4u, thread::hardware_concurrency());
+    const int HOT_COURSES = 4, CAPACITY = 250, STUDENTS_PER_THREAD = 500, ATTEMPTS_PER_THREAD = 200000;
+
+    vector<Course*> courses;
+    for (int c = 0; c < HOT_COURSES; c++) {
+        courses.push_back(new Course("HOT" + to_string(100 + c), "Hot Course", "Stress benchmark", 4, CAPACITY));
+    }
+
+    vector<Student> students(THREADS * STUDENTS_PER_THREAD);
+    for (size_t i = 0; i < students.size(); i++) {
+        students[i].trySetPersonID(10000 + i);
+    }
+
+    // enrolled, already enrolled, waitlisted, rejected
+    vector<array<long long, 4>> outcomes(THREADS, array<long long, 4>{});
+    double seconds = secondsFor([&]() {
+        vector<thread> workers;
+        for (int t = 0; t < THREADS; t++) {
+            workers.emplace_back([&, t]() {
+                array<long long, 4> counts = {};
+                for (int i = 0; i < ATTEMPTS_PER_THREAD; i++) {
+                    int index = t * STUDENTS_PER_THREAD + i % STUDENTS_PER_THREAD;
+                    Course* course = courses[(index + i / STUDENTS_PER_THREAD) % HOT_COURSES];
+                    Result<Course::Enrollment> result = course->tryEnrollStudent(&students[index], "01/06/23");
+                    counts[result ? result.value().status : 3]++;
+                }
+                outcomes[t] = counts;
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    });
+
+    array<long long, 4> totals = {};
+    for (auto& counts : outcomes) {
+        for (int k = 0; k < 4; k++) totals[k] += counts[k];
+    }
+    bool overfilled = false;
+    int total = 0;
+    for (auto course : courses) {
+        int enrolled = course->getEnrolledCount();
+        if (enrolled > CAPACITY) overfilled = true;
+        total += enrolled;
+    }
+    long long attempts = (long long)THREADS * ATTEMPTS_PER_THREAD;
+
+    benchmarkTitle("Concurrent Enrollment");
+    cout << "Threads: " << THREADS << ", Students: " << students.size() << ", Attempts: " << attempts << ", Seats: " << HOT_COURSES * CAPACITY << "\n";
+    cout << "Enrolled: " << total << (overfilled || total != totals[Course::ENROLLED] ? " (MISMATCH!)" : "")
+         << ", Already Enrolled: " << totals[Course::ALREADY_ENROLLED] << ", Waitlisted: " << totals[Course::WAITLISTED] << ", Rejected: " << totals[3] << "\n";
+    cout << "Time: " << seconds * 1000 << " ms, " << attempts / seconds << " attempts/s, " << seconds * 1e9 * THREADS / attempts << " ns per attempt per thread\n";
+
+    for (auto course : courses) {
+        delete course;
+    }
+}
+
+void benchmarkGradeAnalytics(){
+    const int COURSES = 64, STUDENTS_PER_COURSE = 50000;
+
+    vector<GradeBook*> books;
+    {
+        QuietConsole quiet;
+        unsigned seed = 12345;
+        for (int c = 0; c < COURSES; c++){
+            GradeBook* book = new GradeBook();
+            for (int s = 0; s < STUDENTS_PER_COURSE; s++){
+                seed = seed * 1103515245 + 12345;
+                book->addGrade(to_string(c * STUDENTS_PER_COURSE + s), (seed >> 16) % 101);
+            }
+            books.push_back(book);
+        }
+    }
+
+    long long scalarSum = 0;
+    double scalarSeconds = secondsFor([&](){
+        for (auto book : books){
+            for (uint8_t g : book->getGradeColumn()){
+                scalarSum += g;
+            }
+        }
+    });
+
+    GradeStats total;
+    double cohortSeconds = secondsFor([&](){ total = GradeAnalytics::combine(CohortAnalytics::summarize(books)); });
+
+    benchmarkTitle("Grade Analytics");
+    cout << "Grades: " << total.count << " across " << COURSES << " courses\n";
+    cout << "Mean: " << total.mean << ", Std Dev: " << total.stddev << ", Range: " << total.lowest << "-" << total.highest
+         << (scalarSum == total.sum ? "" : " (SUM MISMATCH!)") << "\n";
+    cout << "Scalar sum: " << scalarSeconds * 1000 << " ms, Full cohort statistics: " << cohortSeconds * 1000 << " ms\n";
+
+    for (auto book : books){
+        delete book;
+    }
+}
+
+void benchmarkSnapshot(){
+    const int DEPARTMENTS = 20, PROFESSORS_PER_DEPARTMENT = 50, COURSES = 400, STUDENTS = 40000, COURSES_PER_STUDENT = 5;
+    const string path = "university_snapshot.bin";
+
+    UniversityState state, loaded;
+    SnapshotView view;
+    bool mapped = false;
+    double saveSeconds, mapSeconds, loadSeconds;
+    {
+        QuietConsole quiet;
+        state.university = new University("Benchmark University", "Delhi");
+        for (int d = 0; d < DEPARTMENTS; d++) {
+            Department* department = new Department("Department " + to_string(d), "Block " + to_string(d), 1000000);
+            state.university->addDepartment(department);
+            state.departments.push_back(department);
+            for (int p = 0; p < PROFESSORS_PER_DEPARTMENT; p++) {
+                Professor* professor = new FullProfessor(department->getDepartmentName(), "01/01/15", "Research", p % 20, p, p == 0);
+                professor->setPersonID(10000 + d * PROFESSORS_PER_DEPARTMENT + p);
+                department->addProfessor(professor);
+                state.people.push_back(professor);
+            }
+        }
+        for (int c = 0; c < COURSES; c++) {
+            Course* course = new Course("CS" + to_string(1000 + c), "Course " + to_string(c), "Benchmark course", 4, STUDENTS);
+            course->setInstructor(state.departments[c % DEPARTMENTS]->getDepartmentProfessors()[c % PROFESSORS_PER_DEPARTMENT]);
+            state.courses.push_back(course);
+            state.gradebooks.push_back(new GradeBook());
+        }
+        state.enrollments = new EnrollmentManager();
+        for (int s = 0; s < STUDENTS; s++) {
+            Student* student = new UndergraduateStudent("01/08/23", "B.Tech", 3.0, "Computer Science", "Mathematics", "30/06/27");
+            student->setPersonID(50000 + s % 50000);
+            state.people.push_back(student);
+            for (int k = 0; k < COURSES_PER_STUDENT; k++) {
+                int c = (s * 7 + k * 13) % COURSES;
+                state.courses[c]->enrollStudent(student, "01/09/23");
+                state.gradebooks[c]->addGrade(to_string(s), (s + k) % 101);
+                state.enrollments->enrollStudent(state.courses[c]->getCourseCode(), to_string(s));
+            }
+        }
+
+        saveSeconds = secondsFor([&]() { UniversitySnapshot::save(path, state); });
+        mapSeconds = secondsFor([&]() { mapped = view.open(path); });
+        loadSeconds = secondsFor([&]() { UniversitySnapshot::load(path, loaded); });
+    }
+
+    benchmarkTitle("Snapshot");
+    cout << "People: " << loaded.people.size() << ", Courses: " << loaded.courses.size()
+         << ", Grades: " << (mapped ? view.count(SNAP_GRADE_VALUES) : 0) << "\n";
+    cout << "Save: " << saveSeconds * 1000 << " ms, Map: " << mapSeconds * 1000 << " ms, Full restore: " << loadSeconds * 1000 << " ms\n";
+
+    view.close();
+    remove(path.c_str());
+    loaded.release();
+    state.release();
+}
+
+void benchmarkWriteAheadLog(){
+    const int THREADS = max(4u, thread::hardware_concurrency()), ENROLLMENTS_PER_THREAD = 500;
+    const string path = "university_wal_benchmark.log";
+    remove(path.c_str());
+
+    WriteAheadLog wal;
+    if (!wal.open(path)) {
+        cout << "Unable to open benchmark log!\n";
+        return;
+    }
+    EnrollmentManager manager;
+    manager.setWriteAheadLog(&wal);
+
+    UniversityState recovered;
+    double seconds;
+    {
+        QuietConsole quiet;
+        seconds = secondsFor([&]() {
+            vector<thread> workers;
+            for (int t = 0; t < THREADS; t++) {
+                workers.emplace_back([&, t]() {
+                    for (int i = 0; i < ENROLLMENTS_PER_THREAD; i++) {
+                        manager.enrollStudent("CS" + to_string(100 + i % 20), to_string(t * ENROLLMENTS_PER_THREAD + i));
+                    }
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        });
+
+        UniversityRecovery::recover("university_wal_benchmark.snapshot", path, recovered);
+    }
+
+    int total = 0;
+    for (int c = 0; c < 20; c++) {
+        total += recovered.enrollments ? recovered.enrollments->getEnrollmentCount("CS" + to_string(100 + c)) : 0;
+    }
+    benchmarkTitle("Write-Ahead Log");
+    cout << "Durable Enrollments: " << wal.getRecordCount() << " in " << wal.getBatchCount() << " fsync batches\n";
+    cout << "Time: " << seconds * 1000 << " ms, Recovered: " << total << "\n";
+
+    wal.close();
+    recovered.release();
+    remove(path.c_str());
+}
+
+void benchmarkBulkImport(){
+    const int PEOPLE = 300000, COURSES = 2000;
+    const string peoplePath = "university_import_people.csv", coursePath = "university_import_courses.tsv";
+
+    {
+        ofstream people(peoplePath);
+        people << "kind,name,age,id,contact,fields...\n";
+        for (int i = 0; i < PEOPLE; i++) {
+            int ID = 10000 + i % 90000;
+            long long contact = 9000000000LL + i;
+            if (i % 10 == 0) {
+                people << "full_professor,Professor " << i << ",45," << ID << "," << contact << ",Computer Science,01/07/10,Systems,12,"
+                       << i % 40 << "," << (i % 100 == 0) << "\n";
+            } else if (i % 10 == 1) {
+                people << "graduate,Scholar " << i << ",25," << ID << "," << contact << ",01/08/22,PhD,3.7,Databases,Query Planning\n";
+            } else {
+                people << "undergraduate,Student " << i << ",19," << ID << "," << contact << ",01/08/23,B.Tech,"
+                       << (i % 40) / 10.0 << ",Computer Science,Mathematics,30/06/27\n";
+            }
+        }
+        ofstream courses(coursePath);
+        courses << "code\ttitle\tdescription\tcredits\tmax_capacity\tdeadline\n";
+        for (int c = 0; c < COURSES; c++) {
+            courses << "CS" << 1000 + c << "\tCourse " << c << "\tImported course\t4\t120\t31/12/23\n";
+        }
+    }
+
+    BulkImporter importer;
+    vector<Person*> people;
+    vector<Course*> courses;
+    BulkImporter::Report peopleReport = importer.importPeople(peoplePath, people);
+    BulkImporter::Report courseReport = importer.importCourses(coursePath, courses);
+
+    benchmarkTitle("Bulk Import");
+    cout << "People: ";
+    peopleReport.display();
+    cout << "Courses: ";
+    courseReport.display();
+
+    remove(peoplePath.c_str());
+    remove(coursePath.c_str());
+}
+
+void benchmarkTimetable(){
+    const int COURSES = 2000, ROOMS = 200, PROFESSORS = 500, COHORTS = 200, STUDENTS_PER_COHORT = 60;
+    const int COHORT_COURSES = COURSES / COHORTS;
+    mt19937 random(42);
+
+    vector<Professor*> professors;
+    for (int p = 0; p < PROFESSORS; p++) professors.push_back(new Professor("Computer Science", "01/07/15", "Systems"));
+    vector<Classroom*> rooms;
+    const int sizes[4] = {40, 60, 100, 150};
+    for (int r = 0; r < ROOMS; r++) rooms.push_back(new Classroom("R" + to_string(r), "Block " + to_string(r / 20), sizes[r % 4], r % 5 < 3));
+    vector<Course*> courses;
+    vector<Student*> students;
+    {
+        QuietConsole quiet;
+        for (int c = 0; c < COURSES; c++) {
+            courses.push_back(new Course("CS" + to_string(1000 + c), "Course " + to_string(c), "Synthetic", 3, 200));
+            courses.back()->setInstructor(professors[c % PROFESSORS]);
+        }
+
+        // Students take four courses from their cohort; two in three also take an elective anywhere.
+        for (int k = 0; k < COHORTS; k++) {
+            for (int s = 0; s < STUDENTS_PER_COHORT; s++) {
+                Student* student = new Student("01/08/23", "B.Tech", 3.0);
+                student->setPersonID(10000 + (int)students.size());
+                students.push_back(student);
+                int first = random() % COHORT_COURSES;
+                for (int i = 0; i < 4; i++) courses[k * COHORT_COURSES + (first + i) % COHORT_COURSES]->enrollStudent(student, "01/09/23");
+                if (s % 3 != 0) courses[random() % COURSES]->enrollStudent(student, "01/09/23");
+            }
         }
     }
-    
-    void setClassroomCapacity(int capacity) {
-        if (capacity > 0) {
-            this->capacity = capacity;
-            cout << "Classroom Capacity Updated Successfully!\n";
-        } else {
-            cout << "Capacity Must be Positive!\nCapacity not Updated!\n";
+
+    TimetableSolver solver;
+    for (int c = 0; c < COURSES; c++) solver.addCourse(courses[c], 0, c % 5 == 0);
+    for (auto room : rooms) solver.addClassroom(room);
+    for (int p = 0; p < PROFESSORS; p++) {
+        uint64_t available = 0;
+        for (int day = 0; day < 5; day++) {
+            if (day == p % 5) continue;
+            for (int period = 0; period < 8; period++) available |= solver.periodBit(day, period);
         }
+        solver.setProfessorAvailability(professors[p], available);
     }
-    
-    void setClassroomHasProjector(bool has_projector) {
-        this->has_projector = has_projector;
-        cout << "Classroom Projector Status Updated Successfully!\n";
+    TimetableSolver::Result result = solver.solve();
+    Schedule schedule;
+    size_t applied;
+    {
+        QuietConsole quiet;
+        applied = solver.apply(result, schedule);
     }
 
-    void displayClassroomDetails() {
-        cout << "Classroom Details:\n";
-        cout << "Room Number: " << room_number << "\n";
-        cout << "Building: " << building << "\n";
-        cout << "Capacity: " << capacity << "\n";
-        cout << "Has Projector: " << (has_projector ? "Yes" : "No") << "\n";
-    }
-};
+    benchmarkTitle("Timetable");
+    cout << COURSES << " Courses, " << ROOMS << " Rooms, " << students.size() << " Students\n";
+    result.display();
+    cout << "Added to Schedule: " << applied << "\n";
 
-class Schedule {
-private:
-    struct TimeSlot {
-        string day;
-        string start_time;
-        string end_time;
-        Course* course;
-        Classroom* classroom;
-    };
-    vector<TimeSlot> time_slots;
-public:
-    Schedule() {}
-    
-    void addTimeSlot(string day, string start_time, string end_time, Course* course, Classroom* classroom) {      
-        
-        for (auto slot : time_slots) {
-            if (slot.day == day && slot.classroom == classroom) {
-                if ((start_time >= slot.start_time && start_time < slot.end_time) || (end_time > slot.start_time && end_time <= slot.end_time) ||
-                    (start_time <= slot.start_time && end_time >= slot.end_time)) {
-                    cout << "Time Slot Conflict in Room " << classroom->getClassroomRoomNumber() << "!\nTime Slot Not Added!\n";
-                    return;
+    for (auto student : students) delete student;
+    for (auto course : courses) delete course;
+    for (auto room : rooms) delete room;
+    for (auto professor : professors) delete professor;
+}
+
+void benchmarkPayroll(){
+    const int PEOPLE = 200000;
+    const char* departments[4] = {"Computer Science", "Mathematics", "Physics", "Biology"};
+
+    vector<Person*> people;
+    {
+        QuietConsole quiet;
+        for (int i = 0; i < PEOPLE; i++) {
+            const char* department = departments[i % 4];
+            switch (i % 5) {
+                case 0: people.push_back(new UndergraduateStudent("01/08/23", department, 3.1, "Major", "Minor", "30/06/27")); break;
+                case 1: {
+                    GraduateStudent* graduate = new GraduateStudent("01/08/22", department, 3.6, "Topic", "Thesis");
+                    if (i % 3 == 0) graduate->assignResearchAssistantship(12000 + i % 1000, 20);
+                    people.push_back(graduate);
+                    break;
                 }
+                case 2: people.push_back(new AssistantProfessor(department, "01/07/18", "Systems", i % 6, i % 20, i % 2 == 0)); break;
+                case 3: people.push_back(new AssociateProfessor(department, "01/07/12", "Theory", i % 12, i % 8, i % 30)); break;
+                case 4: people.push_back(new FullProfessor(department, "01/07/02", "Algorithms", i % 25, i % 40, i % 50 == 4)); break;
             }
         }
-            
-        TimeSlot new_slot = {day, start_time, end_time, course, classroom};
-        time_slots.push_back(new_slot);
-        cout << "Time Slot Added Successfully!\n";
     }
-    
-    void removeTimeSlot(string day, string start_time, Course* course) {
-        for (int i = 0; i < time_slots.size(); i++) {
-            if (time_slots[i].day == day && 
-                time_slots[i].start_time == start_time && 
-                time_slots[i].course == course) {
-                time_slots.erase(time_slots.begin() + i);
-                cout << "Time Slot Removed Successfully!\n";
-                return;
+
+    double virtual_total = 0;
+    double virtual_seconds = secondsFor([&]() {
+        for (auto person : people) virtual_total += person->calculatePayment();
+    });
+
+    PayrollEngine engine;
+    engine.load(people);
+    PayrollEngine::Report report = engine.run();
+
+    benchmarkTitle("Payroll");
+    cout << "Virtual Calls: " << virtual_seconds * 1000 << " ms\n";
+    cout << "Batch Engine:  " << report.seconds * 1000 << " ms\n";
+    cout << "Totals Match:  " << (fabs(virtual_total - report.total) < 1 ? "Yes" : "No") << "\n";
+    report.display();
+
+    for (auto person : people) delete person;
+}
+
+void benchmarkPersonPool(){
+    const int PEOPLE = 1000000;
+    const int ROUNDS = 3, SCANS = 5;
+
+    // After the load a random half of the people leave and are replaced, as
+    // students graduate and enroll. The replacements land in whatever memory
+    // was freed, so the heap is no longer walked in address order; the pool
+    // always is.
+    vector<int> leaving(PEOPLE);
+    for (int i = 0; i < PEOPLE; i++) leaving[i] = i;
+    shuffle(leaving.begin(), leaving.end(), mt19937(7));
+    leaving.resize(PEOPLE / 2);
+
+    // Each side keeps its best round and best scan pass; a single pass over a
+    // million people is at the mercy of the rest of the machine.
+    double heap_seconds = 1e9, pool_seconds = 1e9, heap_scan = 1e9, pool_scan = 1e9;
+    double heap_total = 0, pool_total = 0;
+    ObjectPool<UndergraduateStudent> pool;
+    vector<UndergraduateStudent*> pooled(PEOPLE);
+    {
+        QuietConsole quiet;
+        for (int round = 0; round < ROUNDS; round++) {
+            vector<UndergraduateStudent*> heap(PEOPLE);
+            double seconds = secondsFor([&]() {
+                for (int i = 0; i < PEOPLE; i++) heap[i] = new UndergraduateStudent("01/08/23", "B.Tech", 3.0, "Major", "Minor", "30/06/27");
+                for (int i : leaving) delete heap[i];
+                for (int i : leaving) heap[i] = new UndergraduateStudent("01/08/24", "B.Tech", 3.5, "Major", "Minor", "30/06/28");
+            });
+            for (int pass = 0; pass < SCANS; pass++) {
+                heap_scan = min(heap_scan, secondsFor([&]() {
+                    double total = 0;
+                    for (auto student : heap) total += student->getStudentGPA();
+                    heap_total = total;
+                }));
+            }
+            seconds += secondsFor([&]() {
+                for (auto student : heap) delete student;
+            });
+            heap_seconds = min(heap_seconds, seconds);
+
+            seconds = secondsFor([&]() {
+                for (int i = 0; i < PEOPLE; i++) pooled[i] = pool.create("01/08/23", "B.Tech", 3.0, "Major", "Minor", "30/06/27");
+                for (int i : leaving) pool.destroy(pooled[i]);
+                for (int i : leaving) pooled[i] = pool.create("01/08/24", "B.Tech", 3.5, "Major", "Minor", "30/06/28");
+            });
+            for (int pass = 0; pass < SCANS; pass++) {
+                pool_scan = min(pool_scan, secondsFor([&]() {
+                    double total = 0;
+                    pool.forEachRun([&total](UndergraduateStudent* run, size_t count) {
+                        double sum = 0;
+                        for (size_t i = 0; i < count; i++) sum += run[i].getStudentGPA();
+                        total += sum;
+                    });
+                    pool_total = total;
+                }));
             }
+            seconds += secondsFor([&]() { pool.clear(); });
+            pool_seconds = min(pool_seconds, seconds);
         }
-        cout << "Time Slot Not Found!\n";
     }
-    
-    vector<TimeSlot> getCourseSchedule(Course* course) {
-        vector<TimeSlot> course_slots;
-        for (auto slot : time_slots) {
-            if (slot.course == course) {
-                course_slots.push_back(slot);
-            }
-         }
-        return course_slots;
+
+    benchmarkTitle("Person Pool");
+    cout << "People:            " << PEOPLE << ", half replaced, best of " << ROUNDS << " rounds\n";
+    cout << "new/delete:        " << heap_seconds * 1000 << " ms to load, replace and free (scan " << heap_scan * 1000 << " ms)\n";
+    cout << "ObjectPool:        " << pool_seconds * 1000 << " ms to load, replace and clear (scan " << pool_scan * 1000 << " ms)\n";
+    cout << "Totals Match:      " << (fabs(heap_total - pool_total) < 1 ? "Yes" : "No") << "\n";
+}
+
+void benchmarkPersonStore(){
+    const int PEOPLE = 1000000;
+    const int QUERIES = 20;
+
+    PersonStore store;
+    PersonPool pool;
+    vector<Person*> people;
+    mt19937_64 random(7);
+    {
+        QuietConsole quiet;
+        for (int i = 0; i < PEOPLE; i++) {
+            Person* person;
+            if (i % 4 == 3) person = pool.create<Professor>("Computer Science", "01/07/15", "Systems");
+            else person = pool.create<Student>("01/08/23", "B.Tech", (random() % 401) / 100.0);
+            person->setPersonName("Person " + to_string(i));
+            person->setPersonID(10000 + i % 90000);
+            person->setPersonAge(17 + random() % 60);
+            person->setPersonContactInfo(9000000000LL + i);
+            person->setPersonStore(&store);
+            people.push_back(person);
+        }
+        // Objects would normally be created over time and end up scattered.
+        shuffle(people.begin(), people.end(), random);
     }
-    
-    vector<TimeSlot> getClassroomSchedule(Classroom* classroom) {
-        vector<TimeSlot> classroom_slots;
-        for (auto slot : time_slots) {
-            if (slot.classroom == classroom) {
-                classroom_slots.push_back(slot);
+
+    size_t object_count = 0, store_count = 0;
+    Person* object_found = nullptr;
+    Person* store_found = nullptr;
+    double object_seconds = secondsFor([&]() {
+        for (int q = 0; q < QUERIES; q++) {
+            for (auto person : people) {
+                Student* student = dynamic_cast<Student*>(person);
+                object_count += student != nullptr && student->getStudentGPA() > 3.5;
             }
+            long long int contact = 9000000000LL + (q * 48271) % PEOPLE;
+            for (auto person : people) {
+                if (person->getPersonContact_info() == contact) {
+                    object_found = person;
+                    break;
+                }
+            }
+        }
+    });
+
+    double store_seconds = secondsFor([&]() {
+        for (int q = 0; q < QUERIES; q++) {
+            store_count += store.countGPAAbove(3.5);
+            store_found = store.findByContact(9000000000LL + (q * 48271) % PEOPLE);
+        }
+    });
+
+    benchmarkTitle("Person Store");
+    cout << "People:            " << PEOPLE << " (" << QUERIES << " GPA filters and contact lookups)\n";
+    cout << "Object Scans:      " << object_seconds * 1000 << " ms\n";
+    cout << "Column Scans:      " << store_seconds * 1000 << " ms\n";
+    cout << "Students > 3.5:    " << store_count / QUERIES << "\n";
+    cout << "Results Match:     " << (object_count == store_count && object_found == store_found ? "Yes" : "No") << "\n";
+    cout << "Average GPA:       " << store.averageGPA() << "\n";
+}
+
+template <typename Stats>
+void displayIndexStats(const string& label, const Stats& stats){
+    cout << label << stats.size << " / " << stats.capacity << " slots, load " << stats.load_factor
+         << ", average probe " << stats.average_probe << ", longest probe " << stats.longest_probe << "\n";
+}
+
+// The indexes University, Department and Course keep next to their lists,
+// against the linear scans they replaced.
+void benchmarkIndexes(){
+    const int DEPARTMENTS = 2000;
+    const int PROFESSORS = 20000;
+    const int STUDENTS = 20000;
+    const int LOOKUPS = 1000000;
+    const int SCANS = 2000;
+
+    PersonPool pool;
+    University university("Bench University", "Delhi");
+    vector<Department*> departments;
+    vector<string> department_names;
+    vector<Student*> students;
+    Course course("IDX-101", "Indexes", "Index benchmark", 4, STUDENTS);
+    {
+        QuietConsole quiet;
+        for (int d = 0; d < DEPARTMENTS; d++) {
+            department_names.push_back("Indexed Department " + to_string(d));
+            departments.push_back(new Department(department_names.back(), "Block A", 1000000));
+            university.addDepartment(departments.back());
+        }
+        for (int i = 0; i < PROFESSORS; i++) {
+            Professor* professor = pool.create<Professor>("Computer Science", "01/07/15", "Systems");
+            professor->setPersonID(10000 + i);
+            departments[0]->addProfessor(professor);
+        }
+        for (int i = 0; i < STUDENTS; i++) {
+            Student* student = pool.create<Student>("01/08/23", "B.Tech", 3.0);
+            student->setPersonID(40000 + i);
+            course.tryEnrollStudent(student, "01/09/23");
+            students.push_back(student);
         }
-        return classroom_slots;
     }
-    
-    void displaySchedule() {
-        if (time_slots.empty()) {
-            cout << "No Time Slots in Schedule!\n";
-            return;
+
+    mt19937_64 random(11);
+    vector<int> picks(LOOKUPS);
+    for (auto& pick : picks) pick = random() % PROFESSORS;
+
+    size_t scanned = 0, found = 0;
+    double professor_scan = secondsFor([&]() {
+        for (int i = 0; i < SCANS; i++) {
+            for (auto professor : departments[0]->getDepartmentProfessors()) {
+                if (professor->getPersonID() == 10000 + picks[i]) {
+                    scanned++;
+                    break;
+                }
+            }
         }
-        cout << "Schedule:\n";
-        cout << "Day\tStart\tEnd\tCourse\tRoom\n";
-        for (auto slot : time_slots) {
-            cout << slot.day << "\t" 
-                 << slot.start_time << "\t" 
-                 << slot.end_time << "\t" 
-                 << slot.course->getCourseCode() << "\t" 
-                 << slot.classroom->getClassroomRoomNumber() << "\n";
+    }) / SCANS;
+    double professor_index = secondsFor([&]() {
+        for (int pick : picks) found += departments[0]->findProfessor(10000 + pick) != nullptr;
+    }) / LOOKUPS;
+
+    double department_scan = secondsFor([&]() {
+        for (int i = 0; i < SCANS; i++) {
+            const string& name = department_names[picks[i] % DEPARTMENTS];
+            for (auto department : university.getUniversityDepartments()) {
+                if (department->getDepartmentName() == name) {
+                    scanned++;
+                    break;
+                }
+            }
+        }
+    }) / SCANS;
+    double department_index = secondsFor([&]() {
+        for (int pick : picks) found += university.findDepartment(department_names[pick % DEPARTMENTS]) != nullptr;
+    }) / LOOKUPS;
+
+    // Enrolling someone already on the roster is answered by the roster index.
+    size_t duplicates = 0;
+    double duplicate_check = secondsFor([&]() {
+        for (int pick : picks) {
+            Result<Course::Enrollment> result = course.tryEnrollStudent(students[pick % STUDENTS], "01/09/23");
+            duplicates += result && result.value().status == Course::ALREADY_ENROLLED;
         }
+    }) / LOOKUPS;
+
+    OpenHashMap<int, Professor*>::Stats professor_stats = departments[0]->getProfessorIndexStats();
+    OpenHashMap<uint32_t, Department*>::Stats department_stats = university.getDepartmentIndexStats();
+    double remove_professors, remove_departments;
+    {
+        QuietConsole quiet;
+        remove_professors = secondsFor([&]() {
+            for (int i = 0; i < PROFESSORS; i++) departments[0]->removeProfessor(10000 + (i * 7919) % PROFESSORS);
+        });
+        remove_departments = secondsFor([&]() {
+            for (int d = 0; d < DEPARTMENTS; d++) university.removeDepartment(department_names[(d * 7919) % DEPARTMENTS]);
+        });
     }
-};
 
+    benchmarkTitle("Per-Owner Indexes");
+    cout << "Departments:         " << DEPARTMENTS << ", Professors in one: " << PROFESSORS << ", Students in one course: " << STUDENTS << "\n";
+    cout << "Professor by ID:     " << professor_index * 1e9 << " ns (scan " << professor_scan * 1e9 << " ns)\n";
+    cout << "Department by Name:  " << department_index * 1e9 << " ns (scan " << department_scan * 1e9 << " ns)\n";
+    cout << "Duplicate Enroll:    " << duplicate_check * 1e9 << " ns per rejected attempt\n";
+    cout << "Found:               " << found << " of " << 2 * LOOKUPS << ", " << duplicates << " of " << LOOKUPS << " duplicates caught"
+         << (found == 2 * (size_t)LOOKUPS && duplicates == (size_t)LOOKUPS && scanned == 2 * (size_t)SCANS ? "" : " (MISMATCH)") << "\n";
+    cout << "Remove All Profs:    " << remove_professors * 1000 << " ms (" << departments[0]->getDepartmentProfessors().size() << " left)\n";
+    cout << "Remove All Depts:    " << remove_departments * 1000 << " ms (" << university.getUniversityDepartments().size() << " left)\n";
+    displayIndexStats("Professor Index:     ", professor_stats);
+    displayIndexStats("Department Index:    ", department_stats);
+    for (auto department : departments) delete department;
+}
 
+void benchmarkSymbols(){
+    const int STUDENTS = 500000;
+    const int PROGRAMS = 200;
 
+    vector<string> programs;
+    for (int p = 0; p < PROGRAMS; p++) programs.push_back("Bachelor of Technology in Program " + to_string(p));
+    ObjectPool<UndergraduateStudent> pool;
+    vector<UndergraduateStudent*> students;
+    {
+        QuietConsole quiet;
+        for (int i = 0; i < STUDENTS; i++) {
+            students.push_back(pool.create("01/08/23", programs[i % PROGRAMS], 3.0, "Computer Science and Engineering", "Applied Mathematics", "30/06/27"));
+        }
+    }
 
+    const string& target = programs[PROGRAMS / 2];
+    size_t text_matches = 0, symbol_matches = 0;
+    double text_seconds = secondsFor([&]() {
+        for (auto student : students) text_matches += student->getStudentProgram() == target;
+    });
+    double symbol_seconds = secondsFor([&]() {
+        uint32_t symbol = intern(target);
+        for (auto student : students) symbol_matches += student->getStudentProgramSymbol() == symbol;
+    });
 
+    benchmarkTitle("Symbol");
+    cout << "Students:          " << STUDENTS << " over " << PROGRAMS << " programs\n";
+    cout << "Object Size:       " << sizeof(UndergraduateStudent) << " bytes (program, major and minor are " << sizeof(uint32_t) << "-byte symbols, " << sizeof(string) << " bytes each as strings)\n";
+    cout << "String Compares:   " << text_seconds * 1000 << " ms\n";
+    cout << "Symbol Compares:   " << symbol_seconds * 1000 << " ms\n";
+    cout << "Matches Agree:     " << (text_matches == symbol_matches ? "Yes" : "No") << " (" << symbol_matches << ")\n";
+    cout << "Symbols Interned:  " << symbols().size() << "\n";
+}
 
+void benchmarkAllocations(){
+#ifndef UNIVERSITY_COUNT_ALLOCATIONS
+    benchmarkTitle("Allocation");
+    cout << "Skipped: this build does not count heap allocations. Rebuild with:\n  " << COUNTING_BUILD << "\n";
+    return;
+#endif
+    const int OPERATIONS = 100000;
+    const string code = "CS-1004", date = "01/07/15", department = "Computer Science";
+    const string title = "Object Oriented Programming and Design";
+    const string description = "Classes, inheritance, polymorphism and templates in C++";
+    const string specialization = "Distributed Systems and Networks";
+    const string name = "Muhammad Abdullah Khan";
 
-int main(){
-    Person person1; Person person2;
-    person1.setPersonAge(10); person2.setPersonContactInfo(9817256938);
+    // Allocations per call of operation, with console output discarded.
+    auto allocationsPer = [&](auto operation) {
+        QuietConsole quiet;
+        uint64_t before = thread_allocations;
+        for (int i = 0; i < OPERATIONS; i++) operation(i);
+        return (double)(thread_allocations - before) / OPERATIONS;
+    };
 
+    vector<string> titles(OPERATIONS, title), descriptions(OPERATIONS, description), specializations(OPERATIONS, specialization), names(OPERATIONS, name);
+    // Pools are filled once up front and the symbols interned so neither is counted.
+    intern(code);
+    intern(department);
+    ObjectPool<Course> courses;
+    for (int i = 0; i < OPERATIONS; i++) courses.create();
+    courses.clear();
+    double course_copy = allocationsPer([&](int) { courses.create(code, title, description, 3); });
+    courses.clear();
+    double course_move = allocationsPer([&](int i) { courses.create(code, move(titles[i]), move(descriptions[i]), 3); });
 
-    Student Student1; Student Student2;
-    Student1.getPersonAgeID();  Student2.setPersonAge(20);
+    Course& course = *courses.create(code, title, description, 3);
+    descriptions.assign(OPERATIONS, description);
+    double setter_copy = allocationsPer([&](int) { course.setCourseDescription(description); });
+    double setter_move = allocationsPer([&](int i) { course.setCourseDescription(move(descriptions[i])); });
 
+    ObjectPool<FullProfessor> professors;
+    for (int i = 0; i < OPERATIONS; i++) professors.create();
+    professors.clear();
+    double professor_copy = allocationsPer([&](int) { professors.create(department, date, specialization, 10, 5, false); });
+    professors.clear();
+    double professor_move = allocationsPer([&](int i) { professors.create(department, date, move(specializations[i]), 10, 5, false); });
 
-    Professor pr1; Professor pr2;
-    pr1.setPersonName("Aj"); pr2.setPersonAge(99);
+    FullProfessor& professor = *professors.create(department, date, specialization, 10, 5, false);
+    double name_copy = allocationsPer([&](int) { professor.setPersonName(name); });
+    double name_move = allocationsPer([&](int i) { professor.setPersonName(move(names[i])); });
 
-    Course c1; Course c2;
-    c1.setCourseCode("MAL151"); c2.setCourseTitle("Very Bad course T_T");
+    size_t length = 0;
+    double getters = allocationsPer([&](int) {
+        length += course.getCourseTitle().size() + course.getCourseDescription().size() + course.getCourseCode().size();
+        length += professor.getPersonName().size() + professor.getProfessorDepartment().size() + professor.getProfessorSpecialization().size();
+    });
 
+    vector<Person> people(16, professor);
+    double relocate = allocationsPer([&](int i) {
+        Person moved = move(people[i % 16]);
+        people[i % 16] = move(moved);
+    });
 
-    Department d1; Department d2;
-    d1.setDepartmentBudget(1001); d2.setDepartmentLocation("Bahadurgarh");
+    benchmarkTitle("Allocation");
+    cout << "Heap allocations per operation (" << OPERATIONS << " operations each):\n";
+    cout << "Course(code, title, description):      " << course_copy << " copied, " << course_move << " moved\n";
+    cout << "setCourseDescription:                  " << setter_copy << " copied, " << setter_move << " moved\n";
+    cout << "FullProfessor(department, date, spec): " << professor_copy << " copied, " << professor_move << " moved\n";
+    cout << "setPersonName:                         " << name_copy << " copied, " << name_move << " moved\n";
+    cout << "Six string getters:                    " << getters << " (" << length / OPERATIONS << " chars read)\n";
+    cout << "Move a Person out and back:            " << relocate << "\n";
+}
 
+void benchmarkErrorPath(){
+    const int ATTEMPTS = 200000;
 
-    // Part C, point 5
-    vector<Person*> people;
-    
+    Student student;
+    student.trySetPersonID(12345);
+    // The default enrollment deadline is 31/12/23, so every 2024 request is late.
+    Course course("CS-2001", "Data Structures", "Lists, trees and graphs", 3);
+    vector<int> IDs(ATTEMPTS);
+    for (int i = 0; i < ATTEMPTS; i++) IDs[i] = 100 + i % 900;
 
-    Student* s1 = new Student("15/09/2024", "Computer Science", 3.8);
-    s1->setPersonName("Kanan");
-    s1->setPersonID(12345);
-    s1->setPersonAge(18);
-    s1->setPersonContactInfo(9817256938);
-    
-    Student* s2 = new Student("15/02/2023", "Physics", 3.5);
-    s2->setPersonName("Aditi");
-    s2->setPersonID(54321);
-    s2->setPersonAge(16);
-    s2->setPersonContactInfo(1234567890);
-    
+    // Seconds and allocations per attempt; every attempt is rejected.
+    struct Cost {
+        double seconds, allocations;
+        size_t failures;
+    };
+    auto measure = [&](auto attempt) {
+        QuietConsole quiet;
+        size_t failures = 0;
+        uint64_t before = thread_allocations;
+        double seconds = secondsFor([&]() {
+            for (int i = 0; i < ATTEMPTS; i++) failures += attempt(i);
+        });
+        return Cost{seconds / ATTEMPTS, (double)(thread_allocations - before) / ATTEMPTS, failures};
+    };
 
-    Professor* p1 = new Professor("Computer Science", "01/06/2020", "Machine Learning");
-    p1->setPersonName("Richa Singh");
-    p1->setPersonID(98765);
-    p1->setPersonAge(22);
-    p1->setPersonContactInfo(5555555555);
-    
-    Professor* p2 = new Professor("Mathematics", "15/07/2018", "Stats");
-    p2->setPersonName("Rajni Mam");
-    p2->setPersonID(56789);
-    p2->setPersonAge(99);
-    p2->setPersonContactInfo(6666666666);
-    
+    size_t detail_length = 0;
+    Cost id_throw = measure([&](int i) {
+        try {
+            student.setPersonID(IDs[i]);
+            return false;
+        } catch (const UniversitySystemException& e) {
+            detail_length += e.getDetails().size();
+            return true;
+        }
+    });
+    Cost id_result = measure([&](int i) { return !student.trySetPersonID(IDs[i]); });
 
-    people.push_back(s1);
-    people.push_back(p1);
-    people.push_back(s2);
-    people.push_back(p2);
-    
-    cout << "\n------ Polymorphism Behaviour Yayyyyy ------\n";
-    for (auto person : people) {
-        testPerson(person);
-        cout << "--------------------------------------------------\n";
+    Cost enroll_throw = measure([&](int) {
+        try {
+            course.tryEnrollStudent(&student, "01/01/24").valueOrThrow();
+            return false;
+        } catch (const UniversitySystemException& e) {
+            detail_length += e.getDetails().size();
+            return true;
+        }
+    });
+    Cost enroll_result = measure([&](int) { return !course.tryEnrollStudent(&student, "01/01/24"); });
+
+    auto row = [](const char* label, const Cost& cost) {
+        cout << label << cost.seconds * 1e9 << " ns, ";
+#ifdef UNIVERSITY_COUNT_ALLOCATIONS
+        cout << cost.allocations << " allocations per attempt (" << cost.failures << " rejected)\n";
+#else
+        cout << "allocations not counted in this build (" << cost.failures << " rejected)\n";
+#endif
+    };
+    benchmarkTitle("Error Path");
+    cout << "Bad Attempts:      " << ATTEMPTS << " each\n";
+    row("setPersonID throw: ", id_throw);
+    row("trySetPersonID:    ", id_result);
+    row("Late enroll throw: ", enroll_throw);
+    row("tryEnrollStudent:  ", enroll_result);
+    cout << "Details Formatted: " << detail_length / (2 * ATTEMPTS) << " chars on average, only on the throwing paths\n";
+}
+
+void benchmarkDigitValidation(){
+    const int ROWS = 4000000;
+
+    // About one row in a hundred has a bad ID or contact number.
+    mt19937_64 random(5);
+    vector<int> IDs(ROWS);
+    vector<long long> contacts(ROWS);
+    for (int i = 0; i < ROWS; i++) {
+        IDs[i] = random() % 100 == 0 ? (int)(random() % 1000) : 10000 + (int)(random() % 90000);
+        contacts[i] = random() % 100 == 0 ? (long long)(random() % 100000) : 9000000000LL + (long long)(random() % 999999999);
     }
-    
-    for (auto person : people) {
-        delete person;
+
+    // The divide-by-10 count the setters used before.
+    auto digits = [](long long value) {
+        int count = 0;
+        while (value != 0) {
+            value /= 10;
+            count++;
+        }
+        return count;
+    };
+    size_t loop_bad = 0, table_bad = 0;
+    double loop_seconds = secondsFor([&]() {
+        for (int i = 0; i < ROWS; i++) loop_bad += digits(IDs[i]) != 5 || digits(contacts[i]) != 10;
+    });
+    double table_seconds = secondsFor([&]() {
+        for (int i = 0; i < ROWS; i++) table_bad += !validPersonID(IDs[i]) || !validContactNumber(contacts[i]);
+    });
+    vector<uint32_t> invalid;
+    double column_seconds = secondsFor([&]() { invalid = PersonFieldValidator::invalidRows(IDs.data(), contacts.data(), ROWS); });
+
+    benchmarkTitle("Digit Validation");
+    cout << "Rows:              " << ROWS << " (ID and contact number each)\n";
+    cout << "Divide Loop:       " << loop_seconds * 1000 << " ms\n";
+    cout << "Power-of-10 Table: " << table_seconds * 1000 << " ms\n";
+    cout << "Column Validator:  " << column_seconds * 1000 << " ms\n";
+    cout << "Invalid Rows:      " << invalid.size() << (loop_bad == table_bad && table_bad == invalid.size() ? " (all agree)" : " (MISMATCH)") << "\n";
+}
+
+// Checks run by "test". A failed check prints what was expected; the run
+// exits with 1 if any failed.
+int checks_run = 0, checks_failed = 0;
+
+void check(bool passed, const string& what){
+    checks_run++;
+    if (!passed) {
+        checks_failed++;
+        cout << "FAILED: " << what << "\n";
     }
+}
 
-    testAssistantFunctionality();
-    return 0;
+int reportChecks(){
+    cout << checks_run - checks_failed << " of " << checks_run << " Checks Passed\n";
+    return checks_failed == 0 ? 0 : 1;
 }
 
+void testWriteAheadLog(){
+    const string path = "university_test.wal";
+    remove(path.c_str());
+    {
+        WriteAheadLog wal;
+        check(wal.open(path), "log opens");
+        for (int i = 0; i < 3; i++) wal.commit(wal.append(WriteAheadLog::GRADE, "CS-101", to_string(10000 + i), 50 + i));
+        wal.close();
+    }
+    struct stat info;
+    stat(path.c_str(), &info);
+    off_t complete = info.st_size;
 
-//Functions
-bool dateValidator(string &date){
-    vector<string> seperated_dates;
-    string temp = "";
+    vector<int> grades;
+    auto collect = [&grades](WriteAheadLog::RecordType type, const string& courseCode, const string& ID, int value) {
+        if (type == WriteAheadLog::GRADE && courseCode == "CS-101" && ID == to_string(10000 + (int)grades.size())) grades.push_back(value);
+    };
+    bool torn;
+    check(WriteAheadLog::replay(path, collect, torn) == 3 && !torn, "intact log replays every record");
+    check(grades == vector<int>({50, 51, 52}), "records replay in order with their values");
 
-    for (auto c : date){
-        if (c == '/'){
-            seperated_dates.push_back(temp);
-            temp = "";
-        } else {
-            temp += c;
+    // A crash halfway through writing a record leaves a short tail.
+    {
+        ofstream out(path, ios::binary | ios::app);
+        out.write("\x40\0\0\0\x12\x34", 6);
+    }
+    grades.clear();
+    check(WriteAheadLog::replay(path, collect, torn) == 3 && torn, "short tail is reported and skipped");
+    stat(path.c_str(), &info);
+    check(info.st_size == complete, "short tail is trimmed from the file");
+    grades.clear();
+    check(WriteAheadLog::replay(path, collect, torn) == 3 && !torn, "trimmed log replays cleanly");
+
+    // A record whose bytes do not match its checksum ends the log.
+    {
+        fstream file(path, ios::binary | ios::in | ios::out);
+        file.seekp(complete - 1);
+        file.put('\x7f');
+    }
+    grades.clear();
+    check(WriteAheadLog::replay(path, collect, torn) == 2 && torn, "record with a bad checksum is dropped");
+    remove(path.c_str());
+
+    // Every write to /dev/full fails, so each commit below fails after the change.
+    QuietConsole quiet;
+    WriteAheadLog full;
+    if (full.open("/dev/full")) {
+        GradeBook book("CS-101");
+        book.setWriteAheadLog(&full);
+        bool threw = false;
+        try {
+            book.addGrade("10000", 75);
+        } catch (const UniversitySystemException&) {
+            threw = true;
+        }
+        check(!threw && book.HighestMarks() == 75, "a grade that cannot be logged is kept and reported, not thrown");
+        GradeBook unnamed("GB-NEVER-INTERNED");
+        unnamed.setWriteAheadLog(&full);
+        size_t symbolCount = symbols().size();
+        unnamed.addGrade("10000", 60);
+        check(symbols().size() == symbolCount, "reporting an unlogged grade adds no symbol");
+
+        Course course("CS-102", "Logging", "WAL checks", 3, 1);
+        vector<Student> students(2);
+        for (int i = 0; i < 2; i++) students[i].trySetPersonID(10000 + i);
+        course.tryEnrollStudent(&students[0], "01/01/23");
+        course.tryEnrollStudent(&students[1], "01/01/23");
+        course.setWriteAheadLog(&full);
+        int announced = 0;
+        course.setPromotionCallback([&announced](Course&, Student*) { announced++; });
+        threw = false;
+        try {
+            course.setMaxCapacity(2);
+        } catch (const UniversitySystemException&) {
+            threw = true;
+        }
+        check(!threw && course.getEnrolledCount() == 2 && announced == 1, "an unlogged capacity change still announces its promotions");
+
+        EnrollmentManager manager;
+        for (const char* ID : {"30000", "10000", "20000"}) manager.enrollStudent("CS-103", ID);
+        for (const char* code : {"CS-105", "CS-104", "CS-106"}) manager.enrollStudent(code, "10000");
+        // Enough drops that the tombstones get squeezed out of the roster.
+        vector<string> kept;
+        for (int i = 0; i < 100; i++) manager.enrollStudent("CS-107", to_string(40000 + i));
+        for (int i = 0; i < 100; i++) {
+            if (i % 10 != 0) manager.dropStudent("CS-107", to_string(40000 + i));
+            else kept.push_back(to_string(40000 + i));
+        }
+        check(manager.getEnrolledStudents("CS-107") == kept && manager.getEnrollmentCount("CS-107") == 10, "drops keep the rest of the roster in order");
+        manager.setWriteAheadLog(&full);
+        for (auto drop : {make_pair("CS-103", "10000"), make_pair("CS-104", "10000"), make_pair("CS-107", "40050")}) {
+            try {
+                manager.dropStudent(drop.first, drop.second);
+            } catch (const UniversitySystemException&) {}
         }
+        check(manager.getEnrolledStudents("CS-103") == vector<string>({"30000", "10000", "20000"}) && manager.getEnrolledStudents("CS-107") == kept &&
+              manager.getStudentCourses("10000") == vector<string>({"CS-103", "CS-105", "CS-104", "CS-106"}), "an unlogged drop puts the student back where they were");
+
+        check(full.open(path) && full.tryCommit(full.append(WriteAheadLog::GRADE, "CS-101", "10000", 90)), "reopening a failed log starts clean");
+        full.close();
+        check(WriteAheadLog::replay(path, collect, torn) == 1 && !torn, "records from the failed log are not carried over");
+        remove(path.c_str());
     }
-    seperated_dates.push_back(temp);
+}
 
-    if (seperated_dates.size() != 3) return false;
+void testWaitlist(){
+    Course course("WL-101", "Waitlists", "Queue checks", 3, 2);
+    vector<Student> students(5);
+    for (int i = 0; i < 5; i++) students[i].trySetPersonID(20000 + i);
+    vector<int> promoted;
+    course.setPromotionCallback([&promoted](Course&, Student* student) { promoted.push_back(student->getPersonID()); });
 
-    int day, month, year;
-    try{
-        day = stoi(seperated_dates[0]);
-        month = stoi(seperated_dates[1]);
-        year = stoi(seperated_dates[2]);
-    }catch (...){
-        return false;
+    QuietConsole quiet;
+    for (int i = 0; i < 5; i++) {
+        Result<Course::Enrollment> result = course.tryEnrollStudent(&students[i], "01/01/23");
+        bool expected = i < 2 ? result.value().status == Course::ENROLLED
+                              : result.value().status == Course::WAITLISTED && result.value().waitlist_position == i - 1;
+        check(result && expected, "student " + to_string(i) + " enrolls or queues in arrival order");
     }
+    check(course.getEnrolledCount() == 2 && course.getWaitlistSize() == 3, "two seats taken, three waiting");
 
-    if (day<1 || day>31) return false;
-    if (month<1 || month>12) return false;
-    
-    return true;
+    Result<Student*> left = course.tryDropStudent(20003);
+    check(left && left.value() == nullptr, "a waitlisted student can leave the queue");
+    check(course.getWaitlistPosition(20003) == 0 && course.getWaitlistPosition(20004) == 2, "students behind move up");
+
+    Result<Student*> dropped = course.tryDropStudent(20000);
+    check(dropped && dropped.value() == &students[2], "a drop promotes the head of the queue");
+    vector<Student*> roster = course.getEnrolledStudents();
+    check(roster.size() == 2 && roster[0] == &students[1] && roster[1] == &students[2], "promoted student joins the roster");
+    check(course.getWaitlistPosition(20004) == 1, "queue advances after a promotion");
+
+    check(!course.tryDropStudent(20003) && course.tryDropStudent(20003).error().code == 104, "dropping someone not in the course fails");
+
+    course.setMaxCapacity(3);
+    check(course.getEnrolledCount() == 3 && course.getWaitlistSize() == 0, "raising capacity promotes the rest of the queue");
+    check(promoted == vector<int>({20004}), "tryDropStudent leaves announcing a promotion to its caller");
+
+    // Lowering the capacity below the roster: drops free no seats until it fits again.
+    Course shrunk("WL-102", "Waitlists", "Queue checks", 3, 3);
+    for (int i = 0; i < 4; i++) shrunk.tryEnrollStudent(&students[i], "01/01/23");
+    shrunk.setMaxCapacity(1);
+    Result<Student*> over = shrunk.tryDropStudent(20000);
+    check(over && over.value() == nullptr && shrunk.getEnrolledCount() == 2 && shrunk.getWaitlistSize() == 1, "a drop over capacity promotes nobody");
+    shrunk.tryDropStudent(20001);
+    Result<Student*> fits = shrunk.tryDropStudent(20002);
+    check(fits && fits.value() == &students[3] && shrunk.getEnrolledCount() == 1, "promotion resumes once the roster is under capacity");
 }
 
-void testPerson(Person* person){
-    person->displayDetails();
-    cout << "Person's Payment: " << person->calculatePayment() << endl;
+void testObjectPool(){
+    ObjectPool<int, 128> pool;
+    vector<int*> numbers;
+    for (int i = 0; i < 300; i++) numbers.push_back(pool.create(i));
+    check(pool.size() == 300 && pool.capacity() == 384, "objects fill whole blocks before a new one is taken");
+
+    // Holes at both ends of a bitmap word, across a word boundary and at a block edge.
+    const int gone[] = {0, 63, 64, 127, 128, 200};
+    for (int i : gone) pool.destroy(numbers[i]);
+    pool.destroy(numbers[63]);
+    int outside = 7;
+    pool.destroy(&outside);
+    check(pool.size() == 294, "destroying twice or destroying a stranger does nothing");
+
+    long long sum = 0;
+    int visited = 0;
+    pool.forEach([&](int& n) { sum += n; visited++; });
+    check(visited == 294 && sum == 299 * 300 / 2 - (0 + 63 + 64 + 127 + 128 + 200), "forEach visits exactly the live objects");
+
+    vector<pair<int, size_t>> runs;
+    pool.forEachRun([&runs](int* first, size_t count) { runs.push_back({*first, count}); });
+    vector<pair<int, size_t>> expected = {{1, 62}, {65, 62}, {129, 71}, {201, 55}, {256, 44}};
+    check(runs == expected, "forEachRun reports each stretch of live objects once, split at block ends");
+
+    check(pool.create(500) == numbers[200], "a freed slot is reused first");
+    pool.clear();
+    check(pool.size() == 0 && pool.capacity() == 384 && pool.create(1) == numbers[0], "clear keeps the blocks for reuse");
 }
 
-void testAssistantFunctionality(){
-    GraduateStudent* gradStudent = new GraduateStudent("10/01/2023", "Computer Science PhD", 3.9, "Machine Learning", "Neural Networks for Image Recognition");
-    gradStudent->setPersonName("Kanan");
-    gradStudent->setPersonID(12345);
-    gradStudent->setPersonAge(18);
-    gradStudent->setPersonContactInfo(9876543210);
-    
-    Professor* prof = new FullProfessor("Computer Science", "01/01/2010", "Artificial Intelligence", 15, 30, true);
-    prof->setPersonName("Richa Singh");
-    prof->setPersonID(54321);
-    
-    gradStudent->setGraduateStudentAdvisor(prof);
-    gradStudent->assignTeachingAssistantship(10000, 20);
-    gradStudent->assignResearchAssistantship(15000, 30);
-    
-    cout << "\n------ Graduate Student with Assistantships ------\n";
-    gradStudent->displayDetails();
-    cout << "Total Payment: " << gradStudent->calculatePayment() << endl;
-    
-    gradStudent->removeTeachingAssistantship();
-    cout << "\n------ After Removing Teaching Assistantship ------\n";
-    gradStudent->displayDetails();
-    cout << "Total Payment: " << gradStudent->calculatePayment() << endl;
-    
-    delete gradStudent;
-    delete prof;
+void testGradeBook(){
+    QuietConsole quiet;
+    GradeBook hundred("CS-103"), fifty("CS-104");
+    for (int i = 1; i <= 100; i++) {
+        hundred.addGrade(to_string(10000 + i), i);
+        if (i <= 50) fifty.addGrade(to_string(10000 + i), i);
+    }
+    check(hundred.getPercentile(7) == 7, "the 7th percentile of 100 grades is the 7th grade");
+    bool exact = true;
+    for (int percent : {14, 28, 55, 56}) exact = exact && hundred.getPercentile(percent) == percent;
+    for (int percent : {14, 28, 56}) exact = exact && fifty.getPercentile(percent) == percent / 2;
+    check(exact, "whole-number percentiles land on the exact rank");
+    check(hundred.getPercentile(0) == 1 && hundred.getPercentile(100) == 100, "percentiles clamp to the first and last grade");
+}
+
+void testPersonAssignment(){
+    QuietConsole quiet;
+    PayrollLedger ledger;
+    PersonStore store;
+    FullProfessor head("Computer Science", "01/07/10", "Systems", 12, 30, true);
+    head.setPersonID(11111);
+    head.setPayrollLedger(&ledger);
+    head.setPersonStore(&store);
+    FullProfessor other("Mathematics", "01/07/15", "Algebra", 3, 5, false);
+    other.setPersonID(22222);
+    double pay = other.calculatePayment();
+
+    head = other;
+    check(ledger.getPeopleCount() == 1 && ledger.getTotal() == pay, "a copied professor's pay replaces the target's in the ledger");
+    check(ledger.getDepartment("Mathematics").people == 1 && ledger.getDepartment("Computer Science").people == 0, "the ledger moves the target to the copied department");
+    check(store.size() == 1 && store.findByID(22222) == &head && store.findByID(11111) == nullptr, "the store row follows the copied ID");
+
+    head = FullProfessor("Computer Science", "01/07/10", "Systems", 12, 30, true);
+    check(ledger.getPeopleCount() == 1 && ledger.getDepartment("Computer Science").people == 1, "move assignment republishes too");
+    check(other.getPayrollLedger() == nullptr && other.getPersonStore() == nullptr, "assigning from a person does not attach it");
+
+    GraduateStudent graduate;
+    graduate = GraduateStudent("01/08/22", "PhD", 3.8, "Databases", "Query Planning");
+    check(graduate.getGraduateStudentResearchTopic() == "Databases" && graduate.getGraduateStudentThesisTitle() == "Query Planning" &&
+          graduate.getStudentGPA() == 3.8, "move assignment copies every level once");
+    Person& sliced = graduate;
+    sliced = Professor("Mathematics", "01/07/15", "Algebra");
+    check(graduate.getGraduateStudentResearchTopic() == "Databases", "assigning another kind through a base reference copies only the shared fields");
+}
+
+void testPersonFieldValidator(){
+    check(!PersonFieldValidator::validID(9999) && PersonFieldValidator::validID(10000), "IDs start at 10000");
+    check(PersonFieldValidator::validID(99999) && !PersonFieldValidator::validID(100000), "IDs end at 99999");
+    check(!PersonFieldValidator::validID(-12345) && !PersonFieldValidator::validID(0), "negative and zero IDs fail");
+    check(!PersonFieldValidator::validContact(999999999LL) && PersonFieldValidator::validContact(1000000000LL), "contacts start at 10 digits");
+    check(PersonFieldValidator::validContact(9999999999LL) && !PersonFieldValidator::validContact(10000000000LL), "contacts end at 10 digits");
+    check(!PersonFieldValidator::validContact(-9876543210LL), "negative contacts fail");
+
+    // hasDigitCount itself counts digits of the magnitude.
+    check(hasDigitCount(-12345, 5) && !hasDigitCount(-1234, 5) && hasDigitCount(LLONG_MIN, 19), "digit counts ignore the sign");
+    check(hasDigitCount(0, 1) == false && hasDigitCount(9, 1), "zero has no digits");
+
+    // The setters follow the column validator's rule.
+    Student person;
+    check(!person.trySetPersonID(-12345) && !person.trySetPersonContactInfo(-9876543210LL), "setters refuse negative IDs and contacts");
+    check(person.trySetPersonID(12345) && person.trySetPersonContactInfo(9876543210LL), "setters take the values the column validator takes");
+
+    // Long enough for full AVX2 blocks plus a scalar tail, with bad rows at both.
+    const size_t ROWS = 21;
+    vector<int> IDs(ROWS, 54321);
+    vector<long long> contacts(ROWS, 9876543210LL);
+    IDs[0] = 9999;
+    IDs[7] = 100000;
+    contacts[8] = 10000000000LL;
+    IDs[15] = INT_MIN;
+    contacts[16] = LLONG_MIN;
+    contacts[20] = 999999999LL;
+    check(PersonFieldValidator::invalidRows(IDs.data(), contacts.data(), ROWS) == vector<uint32_t>({0, 7, 8, 15, 16, 20}), "column validator flags exactly the bad rows");
+    check(PersonFieldValidator::invalidRows(IDs.data() + 1, contacts.data() + 1, 6).empty(), "a clean column has no bad rows");
+
+    // Packed dates are pure calendar keys; the owner keeps the typed year width.
+    check(parseDate("15/09/2024") == parseDate("15/09/24") && parseDate("01/01/2024") < parseDate("01/01/25"), "packed dates compare by calendar day only");
+    check(formatDate(parseDate("15/09/2024"), fourDigitYear("15/09/2024")) == "15/09/2024" && formatDate(parseDate("1/9/24"), fourDigitYear("1/9/24")) == "01/09/24", "dates keep their year width");
+    check(formatDate(parseDate("01/01/1999")) == "01/01/1999", "years outside 2000-2099 print in full");
+    Student typed("15/09/2024", "B.Tech", 3.0);
+    check(typed.getStudentEnrollmentDate() == "15/09/2024" && typed.getStudentEnrollmentDay() == packDate(15, 9, 2024), "a student's date prints as typed and keys by day");
+    uint32_t dates[2] = {parseDate("31/12/2023"), parseDate("01/01/24")};
+    uint8_t on_time[2];
+    Course course("DT-101", "Dates", "Deadline widths", 3, 5);
+    {
+        QuietConsole quiet;
+        course.setEnrollmentDeadline("31/12/23");
+    }
+    check(course.checkDeadlines(dates, 2, on_time) == 1 && on_time[0] && !on_time[1], "year width does not change how dates compare");
+}
+
+void testSnapshot(){
+    const string path = "university_test.snapshot";
+    UniversityState state, loaded;
+    {
+        QuietConsole quiet;
+        state.university = new University("Test University", "Delhi");
+        Department* department = new Department("Computer Science", "Block A", 250000);
+        state.university->addDepartment(department);
+        state.departments.push_back(department);
+        Professor* professor = new FullProfessor("Computer Science", "01/07/10", "Systems", 12, 30, true);
+        professor->setPersonID(11111);
+        department->addProfessor(professor);
+        state.people.push_back(professor);
+        GraduateStudent* graduate = new GraduateStudent("01/08/22", "PhD", 3.8, "Databases", "Query Planning");
+        graduate->setPersonID(22222);
+        graduate->setGraduateStudentAdvisor(professor);
+        state.people.push_back(graduate);
+        Student* waiting = new Student("01/08/23", "B.Tech", 3.1);
+        waiting->setPersonID(33333);
+        state.people.push_back(waiting);
+
+        Course* course = new Course("CS-201", "Databases", "Storage and queries", 4, 1);
+        course->setInstructor(professor);
+        course->enrollStudent(graduate, "01/09/23");
+        course->enrollStudent(waiting, "01/09/23");
+        state.courses.push_back(course);
+        GradeBook* book = new GradeBook("CS-201");
+        book->addGrade("22222", 87);
+        book->addGrade("33333", 21);
+        state.gradebooks.push_back(book);
+        state.enrollments = new EnrollmentManager();
+        // Out of ID order, with a drop in the middle, so only enrollment order fits.
+        for (const char* ID : {"33333", "22222", "44444", "11111"}) state.enrollments->enrollStudent("CS-201", ID);
+        state.enrollments->dropStudent("CS-201", "44444");
+        Classroom* room = new Classroom("101", "Block A", 40, true);
+        state.classrooms.push_back(room);
+        state.schedule = new Schedule();
+        state.schedule->addTimeSlot(2, 9 * 60, 10 * 60, course, room);
+
+        UniversitySnapshot::save(path, state);
+        UniversitySnapshot::load(path, loaded);
+    }
+
+    unordered_map<int, Person*> people;
+    for (auto person : loaded.people) people[person->getPersonID()] = person;
+    FullProfessor* professor = dynamic_cast<FullProfessor*>(people[11111]);
+    GraduateStudent* graduate = dynamic_cast<GraduateStudent*>(people[22222]);
+    check(loaded.people.size() == 3 && professor != nullptr && graduate != nullptr && people[33333] != nullptr, "people keep their kinds and IDs");
+    check(professor != nullptr && professor->getFullProfessorWorkYears() == 12 && professor->getProfessorDepartment() == "Computer Science", "subclass fields survive");
+    check(graduate != nullptr && graduate->getGraduateStudentAdvisor() == professor && graduate->getStudentGPA() == 3.8, "advisor link and GPA survive");
+    check(loaded.university != nullptr && loaded.university->getUniversityDepartments().size() == 1 &&
+          loaded.university->getUniversityDepartments()[0]->getDepartmentProfessors() == vector<Professor*>({professor}), "departments keep their professors");
+
+    check(loaded.courses.size() == 1, "courses survive");
+    if (loaded.courses.size() == 1) {
+        Course* course = loaded.courses[0];
+        check(course->getCourseCode() == "CS-201" && course->getMaxCapacity() == 1 && course->getCourseInstructor() == professor, "course fields survive");
+        check(course->getEnrolledStudents() == vector<Student*>({graduate}), "roster survives");
+        check(course->getWaitlistPosition(33333) == 1, "waitlist survives");
+    }
+    check(loaded.gradebooks.size() == 1 && loaded.gradebooks[0]->failingStudents() == vector<string>({"33333"}) &&
+          loaded.gradebooks[0]->HighestMarks() == 87, "grades survive");
+    const vector<string> enrolled = {"33333", "22222", "11111"};
+    check(state.enrollments->getEnrolledStudents("CS-201") == enrolled, "enrollment manager lists students in enrollment order");
+    check(loaded.enrollments != nullptr && loaded.enrollments->getEnrolledStudents("CS-201") == enrolled, "enrollment manager survives in order");
+    check(loaded.schedule != nullptr && loaded.schedule->getTimeSlotCount() == 1 && loaded.classrooms.size() == 1 &&
+          loaded.schedule->getClassroomSchedule(loaded.classrooms[0]).size() == 1, "schedule survives");
+
+    // A damaged header is refused rather than half loaded.
+    {
+        fstream file(path, ios::binary | ios::in | ios::out);
+        file.put('X');
+    }
+    UniversityState damaged;
+    bool refused = false;
+    {
+        QuietConsole quiet;
+        try {
+            UniversitySnapshot::load(path, damaged);
+        } catch (const UniversitySystemException& e) {
+            refused = e.getErrorCode() == 600;
+        }
+    }
+    check(refused && damaged.people.empty(), "damaged snapshot is refused");
+
+    // A roster entry of -1 would restore as a null student.
+    {
+        QuietConsole quiet;
+        UniversitySnapshot::save(path, state);
+    }
+    {
+        fstream file(path, ios::binary | ios::in | ios::out);
+        SnapshotHeader header;
+        SnapshotCourse course;
+        file.read((char*)&header, sizeof(header));
+        file.seekg(header.sections[SNAP_COURSES].offset);
+        file.read((char*)&course, sizeof(course));
+        int32_t missing = -1;
+        file.seekp(header.sections[SNAP_INDICES].offset + course.students.first * sizeof(uint32_t));
+        file.write((const char*)&missing, sizeof(missing));
+    }
+    refused = false;
+    {
+        QuietConsole quiet;
+        try {
+            UniversitySnapshot::load(path, damaged);
+        } catch (const UniversitySystemException& e) {
+            refused = e.getErrorCode() == 600;
+        }
+    }
+    check(refused && damaged.people.empty() && damaged.courses.empty(), "a snapshot with a null roster entry is refused");
+
+    remove(path.c_str());
+    loaded.release();
+    state.release();
+}
+
+void testScheduleConflicts(){
+    Course first("TT-101", "First", "Timetable checks", 3), second("TT-102", "Second", "Timetable checks", 3);
+    Classroom room("201", "Block B", 60, true), other("202", "Block B", 60, false);
+    Schedule schedule;
+    QuietConsole quiet;
+    check(schedule.addTimeSlot("Monday", "09:00", "10:30", &first, &room), "free room takes a slot");
+    check(!schedule.addTimeSlot("Monday", "10:00", "11:00", &second, &room), "overlapping slot in the same room is refused");
+    check(!schedule.addTimeSlot("Mon", "09:00", "10:30", &second, &room), "identical slot in the same room is refused");
+    check(schedule.addTimeSlot("Monday", "10:30", "11:30", &second, &room), "slot starting as another ends fits");
+    check(schedule.addTimeSlot("Monday", "10:00", "11:00", &second, &other), "same time in another room fits");
+    check(schedule.addTimeSlot("Tuesday", "09:00", "10:30", &second, &room), "same time on another day fits");
+    check(!schedule.addTimeSlot("Monday", "11:00", "10:00", &first, &other), "slot ending before it starts is refused");
+    check(!schedule.isClassroomFree(&room, 0, 9 * 60 + 59, 10 * 60 + 1) && schedule.isClassroomFree(&room, 0, 8 * 60, 9 * 60), "room occupancy is minute exact");
+
+    schedule.removeTimeSlot("Monday", "09:00", &first);
+    check(schedule.isClassroomFree(&room, 0, 9 * 60, 10 * 60 + 30), "removing a slot frees the room");
+    check(schedule.addTimeSlot("Monday", "09:00", "10:00", &first, &room), "freed time can be booked again");
+
+    // Days are names or their starts, times are H:MM; other free text is refused.
+    check(Schedule::parseDay("Mo") == 0 && Schedule::parseDay("tues") == 1 && Schedule::parseDay("THURS") == 3 && Schedule::parseDay(" Friday ") == 4, "day names can be shortened and padded");
+    check(Schedule::parseDay("M") == -1 && Schedule::parseDay("Mondays") == -1 && Schedule::parseDay("Day 1") == -1, "text that is not a day is refused");
+    check(Schedule::parseTime(" 9:05") == 9 * 60 + 5 && Schedule::parseTime("9am") == -1 && Schedule::parseTime("0900") == -1, "times are H:MM or HH:MM");
+}
+
+void testTimetable(){
+    QuietConsole quiet;
+
+    // The solver must never double book a room, a course or an instructor.
+    Professor shared("Computer Science", "01/07/15", "Systems");
+    vector<Course*> courses;
+    vector<Classroom*> rooms;
+    for (int c = 0; c < 12; c++) {
+        courses.push_back(new Course("TS-" + to_string(100 + c), "Solver", "Timetable checks", 3, 40));
+        if (c % 3 == 0) courses.back()->setInstructor(&shared);
+    }
+    for (int r = 0; r < 3; r++) rooms.push_back(new Classroom("S" + to_string(r), "Block C", 40, r == 0));
+    TimetableSolver solver;
+    for (int c = 0; c < 12; c++) solver.addCourse(courses[c], 3, c == 0);
+    for (auto classroom : rooms) solver.addClassroom(classroom);
+    TimetableSolver::Result result = solver.solve();
+
+    bool clash = false;
+    for (size_t a = 0; a < result.assignments.size(); a++) {
+        for (size_t b = a + 1; b < result.assignments.size(); b++) {
+            const TimetableSolver::Assignment& x = result.assignments[a];
+            const TimetableSolver::Assignment& y = result.assignments[b];
+            if (x.day != y.day || x.end_minute <= y.start_minute || y.end_minute <= x.start_minute) continue;
+            bool sameInstructor = x.course->getCourseInstructor() != nullptr && x.course->getCourseInstructor() == y.course->getCourseInstructor();
+            clash |= x.classroom == y.classroom || x.course == y.course || sameInstructor;
+        }
+    }
+    check(!clash, "solver output has no room, course or instructor clashes");
+    check(result.assignments.size() + result.unplaced == result.meetings && result.meetings == 36, "every meeting is placed or reported");
+    Schedule solved;
+    check(solver.apply(result, solved) == result.assignments.size(), "solver output fits a schedule without conflicts");
+
+    for (auto course : courses) delete course;
+    for (auto classroom : rooms) delete classroom;
 }